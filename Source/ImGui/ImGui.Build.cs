@@ -45,7 +45,11 @@ public class ImGui : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"ImGuiShaders",
 				"InputCore",
+				"RenderCore",
+				"RHI",
+				"ShaderCore",
 				"Slate",
 				"SlateCore"
 				// ... add private dependencies that you statically link with here ...	
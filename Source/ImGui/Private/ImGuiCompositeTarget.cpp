@@ -0,0 +1,78 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#include "ImGuiCompositeTarget.h"
+
+#include "ImGuiPrivatePCH.h"
+
+#if WITH_IMGUI_SHADERS
+
+#include <Engine/TextureRenderTarget2D.h>
+#include <RenderingThread.h>
+
+
+FImGuiCompositeTarget::FImGuiCompositeTarget()
+	: DrawElement(MakeShareable(new FImGuiDrawElement()))
+{
+}
+
+FImGuiCompositeTarget::~FImGuiCompositeTarget()
+{
+	if (RenderTarget)
+	{
+		if (FSlateApplication::IsInitialized())
+		{
+			FSlateApplication::Get().GetRenderer()->ReleaseDynamicResource(Brush);
+		}
+
+		RenderTarget->RemoveFromRoot();
+		RenderTarget = nullptr;
+	}
+}
+
+void FImGuiCompositeTarget::Render(const TArray<FImGuiDrawList>& DrawLists, uint64 DrawDataHash,
+	const FTextureManager& TextureManager, const FVector2D& VertexPositionOffset, const FSlateRect& ClippingRect)
+{
+	const int32 Width = FMath::CeilToInt(ClippingRect.Right - ClippingRect.Left);
+	const int32 Height = FMath::CeilToInt(ClippingRect.Bottom - ClippingRect.Top);
+
+	if (Width <= 0 || Height <= 0)
+	{
+		return;
+	}
+
+	if (!RenderTarget)
+	{
+		RenderTarget = NewObject<UTextureRenderTarget2D>();
+		RenderTarget->AddToRoot();
+		RenderTarget->ClearColor = FLinearColor::Transparent;
+	}
+
+	if (RenderTarget->SizeX != Width || RenderTarget->SizeY != Height)
+	{
+		// ImGui colors are written to the back buffer without conversion, so we keep them the same here.
+		RenderTarget->InitCustomFormat(Width, Height, PF_B8G8R8A8, true);
+
+		Brush.SetResourceObject(RenderTarget);
+		Brush.ImageSize = FVector2D(Width, Height);
+	}
+
+	// Render target covers the widget clipping rectangle, so it becomes the origin of the target space.
+	const FVector2D TargetOffset = ClippingRect.GetTopLeft();
+	DrawElement->Update(DrawLists, TextureManager, VertexPositionOffset - TargetOffset, ClippingRect.OffsetBy(-TargetOffset));
+
+	using FSharedDrawElement = TSharedRef<FImGuiDrawElement, ESPMode::ThreadSafe>;
+
+	ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
+		ImGuiCompositeTargetRender,
+		FSharedDrawElement, Element, DrawElement.ToSharedRef(),
+		FTextureRenderTargetResource*, TargetResource, RenderTarget->GameThread_GetRenderTargetResource(),
+		{
+			Element->DrawToRenderTarget_RenderThread(RHICmdList, TargetResource);
+		});
+
+	RenderedClippingRect = ClippingRect;
+	RenderedDrawDataHash = DrawDataHash;
+	RenderTime = FPlatformTime::Seconds();
+}
+
+#endif // WITH_IMGUI_SHADERS
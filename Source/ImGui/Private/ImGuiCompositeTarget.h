@@ -0,0 +1,62 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#pragma once
+
+#include "ImGuiDrawElement.h"
+
+#include <Styling/SlateBrush.h>
+
+
+#if WITH_IMGUI_SHADERS
+
+class UTextureRenderTarget2D;
+
+// Render target with cached ImGui output. It allows to render ImGui draw data at a lower rate than the widget is
+// painted and to draw them as a single textured quad in remaining frames.
+class FImGuiCompositeTarget
+{
+public:
+
+	FImGuiCompositeTarget();
+	~FImGuiCompositeTarget();
+
+	FImGuiCompositeTarget(const FImGuiCompositeTarget&) = delete;
+	FImGuiCompositeTarget& operator=(const FImGuiCompositeTarget&) = delete;
+
+	FImGuiCompositeTarget(FImGuiCompositeTarget&&) = delete;
+	FImGuiCompositeTarget& operator=(FImGuiCompositeTarget&&) = delete;
+
+	// Render draw lists to the render target, resizing it if necessary.
+	// @param DrawLists - Draw lists to render
+	// @param DrawDataHash - Hash of draw lists (see FImGuiSlateDrawData::ComputeDrawDataHash)
+	// @param TextureManager - Texture manager to resolve texture indices
+	// @param VertexPositionOffset - Position offset transforming vertices to the widget space
+	// @param ClippingRect - Clipping rectangle of the widget, which defines the area covered by the render target
+	void Render(const TArray<FImGuiDrawList>& DrawLists, uint64 DrawDataHash, const FTextureManager& TextureManager,
+		const FVector2D& VertexPositionOffset, const FSlateRect& ClippingRect);
+
+	// Check whether render target covers this clipping rectangle. If it doesn't, cached output cannot be used.
+	bool HasLayout(const FSlateRect& ClippingRect) const { return RenderTarget && ClippingRect == RenderedClippingRect; }
+
+	// Get hash of draw data rendered to the target.
+	uint64 GetDrawDataHash() const { return RenderedDrawDataHash; }
+
+	// Get time in seconds when the target was rendered the last time.
+	double GetRenderTime() const { return RenderTime; }
+
+	// Get brush that can be used to draw cached output.
+	const FSlateBrush& GetBrush() const { return Brush; }
+
+private:
+
+	UTextureRenderTarget2D* RenderTarget = nullptr;
+	FSlateBrush Brush;
+
+	TSharedPtr<FImGuiDrawElement, ESPMode::ThreadSafe> DrawElement;
+
+	FSlateRect RenderedClippingRect;
+	uint64 RenderedDrawDataHash = 0;
+	double RenderTime = 0.0;
+};
+
+#endif // WITH_IMGUI_SHADERS
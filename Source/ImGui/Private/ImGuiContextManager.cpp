@@ -9,6 +9,9 @@
 #include "Utilities/WorldContext.h"
 #include "Utilities/WorldContextIndex.h"
 
+#include <Async/ParallelFor.h>
+#include <Misc/ScopeRWLock.h>
+
 #include <imgui.h>
 
 
@@ -24,6 +27,27 @@ namespace CVars
 		TEXT("0: disabled, ImGui Debug Draw is called during Post-Tick\n")
 		TEXT("1: enabled (default), ImGui Debug Draw is called during World Tick Start"),
 		ECVF_Default);
+
+	TAutoConsoleVariable<int> ParallelTick(TEXT("ImGui.ParallelTick"), 0,
+		TEXT("Whether ImGui contexts should be ticked in parallel. Draw events are still called on the game thread.\n")
+		TEXT("0: disabled, contexts are ticked one after another on the game thread (default)\n")
+		TEXT("1: enabled, if there are multiple contexts, they are ticked on the task graph"),
+		ECVF_Default);
+
+	TAutoConsoleVariable<int> PipelinedFrame(TEXT("ImGui.PipelinedFrame"), 0,
+		TEXT("Whether ImGui frames should be ended in a task that runs in parallel with the rest of the game frame.\n")
+		TEXT("NOTE: In this mode, world contexts cannot be used after world actors are ticked.\n")
+		TEXT("0: disabled, frames are ended and rendered on the game thread right before Slate paints them (default)\n")
+		TEXT("1: enabled, after world actors are ticked, ImGui rendering and draw data conversion are started in a task, ")
+		TEXT("which is completed before Slate paints them"),
+		ECVF_Default);
+
+	TAutoConsoleVariable<int> ContextPoolSize(TEXT("ImGui.ContextPool.Size"), WITH_EDITOR ? 4 : 0,
+		TEXT("Number of ImGui contexts that are created in advance, one per frame, so new contexts (like those created ")
+		TEXT("when starting multi-PIE sessions) can be initialized without hitches.\n")
+		TEXT("0: disabled, contexts are created on demand (default in game)\n")
+		TEXT("N: keep N contexts ready to use (default in editor: 4)"),
+		ECVF_Default);
 }
 
 namespace
@@ -70,32 +94,91 @@ namespace
 #endif // WITH_EDITOR
 }
 
-FImGuiContextManager::FImGuiContextManager()
+FImGuiContextManager::FImGuiContextManager(FImGuiSharedFontAtlas& InFontAtlas)
+	: FontAtlas(InFontAtlas)
 {
 	FWorldDelegates::OnWorldTickStart.AddRaw(this, &FImGuiContextManager::OnWorldTickStart);
+	FWorldDelegates::OnWorldPostActorTick.AddRaw(this, &FImGuiContextManager::OnWorldPostActorTick);
+	FWorldDelegates::OnWorldCleanup.AddRaw(this, &FImGuiContextManager::OnWorldCleanup);
+	FWorldDelegates::OnPreWorldFinishDestroy.AddRaw(this, &FImGuiContextManager::OnPreWorldFinishDestroy);
 }
 
 FImGuiContextManager::~FImGuiContextManager()
 {
 	// Order matters because contexts can be created during World Tick Start events.
 	FWorldDelegates::OnWorldTickStart.RemoveAll(this);
+	FWorldDelegates::OnWorldPostActorTick.RemoveAll(this);
+	FWorldDelegates::OnWorldCleanup.RemoveAll(this);
+	FWorldDelegates::OnPreWorldFinishDestroy.RemoveAll(this);
+	{
+		FRWScopeLock Lock(PrimitiveDrawListsLock, SLT_Write);
+		PrimitiveDrawLists.Empty();
+	}
 	Contexts.Empty();
+	for (ImGuiContext* PrewarmedContext : PrewarmedContexts)
+	{
+		FImGuiContextProxy::DestroyPrewarmedContext(PrewarmedContext, FontAtlas);
+	}
+	PrewarmedContexts.Empty();
 	ImGui::Shutdown();
 }
 
+FImGuiPrimitiveDrawListsPtr FImGuiContextManager::FindPrimitiveDrawLists(int32 ContextIndex)
+{
+	FRWScopeLock Lock(PrimitiveDrawListsLock, SLT_ReadOnly);
+	const FImGuiPrimitiveDrawListsPtr* Found = PrimitiveDrawLists.Find(ContextIndex);
+	return Found ? *Found : nullptr;
+}
+
+void FImGuiContextManager::WaitForFrameEnds()
+{
+	for (auto& ContextData : Contexts)
+	{
+		if (ContextData)
+		{
+			ContextData->ContextProxy.WaitForFrameEnd();
+		}
+	}
+}
+
 void FImGuiContextManager::Tick(float DeltaSeconds)
 {
 	// In editor, worlds can get invalid. We could remove corresponding entries, but that would mean resetting ImGui
 	// context every time when PIE session is restarted. Instead we freeze contexts until their worlds are re-created.
 
-	for (auto& Pair : Contexts)
+	if (CVars::ParallelTick.GetValueOnGameThread() > 0 && Contexts.Num() > 1)
 	{
-		auto& ContextData = Pair.Value;
-		if (ContextData.CanTick())
+		// Draw events can access objects, so we call them on the game thread and only after that we tick contexts in
+		// parallel. Current context pointer is thread-local, so contexts on different threads don't interfere.
+		TArray<FImGuiContextProxy*, TInlineAllocator<8>> ContextsToTick;
+		for (auto& ContextData : Contexts)
+		{
+			if (ContextData && ContextData->CanTick() && ContextData->ContextProxy.PreTick())
+			{
+				ContextsToTick.Add(&ContextData->ContextProxy);
+			}
+		}
+
+		ParallelFor(ContextsToTick.Num(), [&](int32 Index)
+		{
+			ContextsToTick[Index]->TickFrame(DeltaSeconds);
+
+			// Don't leave worker threads with pointers to contexts that might be destroyed.
+			ImGui::SetCurrentContext(&ImGuiImplementation::GetDefaultContext());
+		});
+	}
+	else
+	{
+		for (auto& ContextData : Contexts)
 		{
-			ContextData.ContextProxy.Tick(DeltaSeconds);
+			if (ContextData && ContextData->CanTick())
+			{
+				ContextData->ContextProxy.Tick(DeltaSeconds);
+			}
 		}
 	}
+
+	PrewarmContexts();
 }
 
 void FImGuiContextManager::OnWorldTickStart(ELevelTick TickType, float DeltaSeconds)
@@ -111,14 +194,59 @@ void FImGuiContextManager::OnWorldTickStart(ELevelTick TickType, float DeltaSeco
 	}
 }
 
+void FImGuiContextManager::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	// Actors are updated, so in pipelined mode we can call remaining draw events and end the frame in parallel with
+	// the rest of the game frame. Like in the tick start, we only handle the world that is currently set in GWorld.
+	if (GWorld && World == GWorld && CVars::PipelinedFrame.GetValueOnGameThread() > 0)
+	{
+		FContextData& ContextData = GetWorldContextData(*GWorld);
+		if (ContextData.CanTick())
+		{
+			ContextData.ContextProxy.EndFrameAsync();
+		}
+	}
+}
+
+void FImGuiContextManager::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	if (bSessionEnded)
+	{
+		// Contexts of ended sessions stop replaying, so drop commands that would wait for them.
+		for (const FWorldContextCacheEntry& Entry : WorldContextCache)
+		{
+#if WITH_EDITOR
+			if (Entry.World == World && Entry.ContextIndex != Utilities::EDITOR_CONTEXT_INDEX)
+#else
+			if (Entry.World == World)
+#endif
+			{
+				DeferredCommands.Discard(Entry.ContextIndex);
+			}
+		}
+	}
+
+	RemoveCachedWorld(World);
+}
+
+void FImGuiContextManager::OnPreWorldFinishDestroy(UWorld* World)
+{
+	RemoveCachedWorld(World);
+}
+
+void FImGuiContextManager::RemoveCachedWorld(const UWorld* World)
+{
+	WorldContextCache.RemoveAllSwap([World](const FWorldContextCacheEntry& Entry) { return Entry.World == World; });
+}
+
 #if WITH_EDITOR
 FImGuiContextManager::FContextData& FImGuiContextManager::GetEditorContextData()
 {
-	FContextData* Data = Contexts.Find(Utilities::EDITOR_CONTEXT_INDEX);
+	FContextData* Data = FindContextData(Utilities::EDITOR_CONTEXT_INDEX);
 
 	if (UNLIKELY(!Data))
 	{
-		Data = &Contexts.Emplace(Utilities::EDITOR_CONTEXT_INDEX, FContextData{ GetEditorContextName(), Utilities::EDITOR_CONTEXT_INDEX, DrawMultiContextEvent, ImGuiDemo, -1 });
+		Data = &AddContextData(Utilities::EDITOR_CONTEXT_INDEX, FContextData{ GetEditorContextName(), Utilities::EDITOR_CONTEXT_INDEX, DrawMultiContextEvent, ImGuiDemo, DeferredCommands, FontAtlas, TakePrewarmedContext(), -1 });
 	}
 
 	return *Data;
@@ -128,11 +256,11 @@ FImGuiContextManager::FContextData& FImGuiContextManager::GetEditorContextData()
 #if !WITH_EDITOR
 FImGuiContextManager::FContextData& FImGuiContextManager::GetStandaloneWorldContextData()
 {
-	FContextData* Data = Contexts.Find(Utilities::STANDALONE_GAME_CONTEXT_INDEX);
+	FContextData* Data = FindContextData(Utilities::STANDALONE_GAME_CONTEXT_INDEX);
 
 	if (UNLIKELY(!Data))
 	{
-		Data = &Contexts.Emplace(Utilities::STANDALONE_GAME_CONTEXT_INDEX, FContextData{ GetWorldContextName(), Utilities::STANDALONE_GAME_CONTEXT_INDEX, DrawMultiContextEvent, ImGuiDemo });
+		Data = &AddContextData(Utilities::STANDALONE_GAME_CONTEXT_INDEX, FContextData{ GetWorldContextName(), Utilities::STANDALONE_GAME_CONTEXT_INDEX, DrawMultiContextEvent, ImGuiDemo, DeferredCommands, FontAtlas, TakePrewarmedContext() });
 	}
 
 	return *Data;
@@ -143,6 +271,19 @@ FImGuiContextManager::FContextData& FImGuiContextManager::GetWorldContextData(co
 {
 	using namespace Utilities;
 
+	// Resolving context index requires searching world contexts, so we cache results for worlds that are alive.
+	for (const FWorldContextCacheEntry& Entry : WorldContextCache)
+	{
+		if (Entry.World == &World)
+		{
+			if (OutIndex)
+			{
+				*OutIndex = Entry.ContextIndex;
+			}
+			return *Contexts[Entry.ContextIndex];
+		}
+	}
+
 #if WITH_EDITOR
 	if (World.WorldType == EWorldType::Editor)
 	{
@@ -151,7 +292,9 @@ FImGuiContextManager::FContextData& FImGuiContextManager::GetWorldContextData(co
 			*OutIndex = Utilities::EDITOR_CONTEXT_INDEX;
 		}
 
-		return GetEditorContextData();
+		FContextData& EditorData = GetEditorContextData();
+		WorldContextCache.Add({ &World, Utilities::EDITOR_CONTEXT_INDEX });
+		return EditorData;
 	}
 #endif
 
@@ -167,12 +310,12 @@ FImGuiContextManager::FContextData& FImGuiContextManager::GetWorldContextData(co
 		Index, *World.GetName(), static_cast<int32>(World.WorldType), static_cast<int32>(World.GetNetMode()));
 #endif
 
-	FContextData* Data = Contexts.Find(Index);
+	FContextData* Data = FindContextData(Index);
 
 #if WITH_EDITOR
 	if (UNLIKELY(!Data))
 	{
-		Data = &Contexts.Emplace(Index, FContextData{ GetWorldContextName(World), Index, DrawMultiContextEvent, ImGuiDemo, WorldContext->PIEInstance });
+		Data = &AddContextData(Index, FContextData{ GetWorldContextName(World), Index, DrawMultiContextEvent, ImGuiDemo, DeferredCommands, FontAtlas, TakePrewarmedContext(), WorldContext->PIEInstance });
 	}
 	else
 	{
@@ -182,13 +325,51 @@ FImGuiContextManager::FContextData& FImGuiContextManager::GetWorldContextData(co
 #else
 	if (UNLIKELY(!Data))
 	{
-		Data = &Contexts.Emplace(Index, FContextData{ GetWorldContextName(World), Index, DrawMultiContextEvent, ImGuiDemo });
+		Data = &AddContextData(Index, FContextData{ GetWorldContextName(World), Index, DrawMultiContextEvent, ImGuiDemo, DeferredCommands, FontAtlas, TakePrewarmedContext() });
 	}
 #endif
 
+	WorldContextCache.Add({ &World, Index });
+
 	if (OutIndex)
 	{
 		*OutIndex = Index;
 	}
 	return *Data;
 }
+
+FImGuiContextManager::FContextData& FImGuiContextManager::AddContextData(int32 Index, FContextData&& Data)
+{
+	if (Index >= Contexts.Num())
+	{
+		Contexts.SetNum(Index + 1);
+	}
+
+	Contexts[Index] = MakeUnique<FContextData>(MoveTemp(Data));
+	FContextData& AddedData = *Contexts[Index];
+
+	FRWScopeLock Lock(PrimitiveDrawListsLock, SLT_Write);
+	PrimitiveDrawLists.Add(Index, AddedData.ContextProxy.GetPrimitiveDrawLists());
+
+	return AddedData;
+}
+
+ImGuiContext* FImGuiContextManager::TakePrewarmedContext()
+{
+	return PrewarmedContexts.Num() > 0 ? PrewarmedContexts.Pop(false) : nullptr;
+}
+
+void FImGuiContextManager::PrewarmContexts()
+{
+	// Creating one context per frame spreads initialization cost over multiple frames, while pool is refilled after
+	// new contexts are created.
+	const int32 PoolSize = FMath::Max(CVars::ContextPoolSize.GetValueOnGameThread(), 0);
+	if (PrewarmedContexts.Num() < PoolSize)
+	{
+		PrewarmedContexts.Add(FImGuiContextProxy::CreatePrewarmedContext(FontAtlas));
+	}
+	else if (PrewarmedContexts.Num() > PoolSize)
+	{
+		FImGuiContextProxy::DestroyPrewarmedContext(PrewarmedContexts.Pop(false), FontAtlas);
+	}
+}
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "ImGuiContextProxy.h"
+#include "ImGuiDeferredCommandQueue.h"
 #include "ImGuiDemo.h"
 
 
@@ -11,7 +12,8 @@ class FImGuiContextManager
 {
 public:
 
-	FImGuiContextManager();
+	// @param InFontAtlas - Font atlas shared by contexts (needs to outlive this manager)
+	explicit FImGuiContextManager(FImGuiSharedFontAtlas& InFontAtlas);
 
 	FImGuiContextManager(const FImGuiContextManager&) = delete;
 	FImGuiContextManager& operator=(const FImGuiContextManager&) = delete;
@@ -40,7 +42,7 @@ public:
 	// Get context proxy by index, or null if context with that index doesn't exist.
 	FORCEINLINE FImGuiContextProxy* GetContextProxy(int32 ContextIndex)
 	{
-		FContextData* Data = Contexts.Find(ContextIndex);
+		FContextData* Data = FindContextData(ContextIndex);
 		return Data ? &(Data->ContextProxy) : nullptr;
 	}
 
@@ -48,6 +50,17 @@ public:
 	// draw the same content to multiple contexts.
 	FSimpleMulticastDelegate& OnDrawMultiContext() { return DrawMultiContextEvent; }
 
+	// Find pool of primitive draw lists for context with given index. Can be called from any thread.
+	// @returns Shared pool of the context or null, if context with that index doesn't exist
+	FImGuiPrimitiveDrawListsPtr FindPrimitiveDrawLists(int32 ContextIndex);
+
+	// Get queue for commands recorded on any thread, which are replayed during draw events of their contexts.
+	FImGuiDeferredCommandQueue& GetDeferredCommands() { return DeferredCommands; }
+
+	// Wait until frames ended asynchronously are complete (see FImGuiContextProxy::EndFrameAsync), so their tasks
+	// don't use fonts anymore.
+	void WaitForFrameEnds();
+
 	void Tick(float DeltaSeconds);
 
 private:
@@ -56,11 +69,14 @@ private:
 
 	struct FContextData
 	{
-		FContextData(const FString& ContextName, int32 ContextIndex, FSimpleMulticastDelegate& SharedDrawEvent, FImGuiDemo& Demo, int32 InPIEInstance = -1)
+		FContextData(const FString& ContextName, int32 ContextIndex, FSimpleMulticastDelegate& SharedDrawEvent, FImGuiDemo& Demo,
+			FImGuiDeferredCommandQueue& DeferredCommands, FImGuiSharedFontAtlas& FontAtlas, ImGuiContext* PrewarmedContext,
+			int32 InPIEInstance = -1)
 			: PIEInstance(InPIEInstance)
-			, ContextProxy(ContextName, &SharedDrawEvent)
+			, ContextProxy(ContextName, &SharedDrawEvent, FontAtlas, PrewarmedContext)
 		{
 			ContextProxy.OnDraw().AddLambda([&Demo, ContextIndex]() { Demo.DrawControls(ContextIndex); });
+			ContextProxy.OnDraw().AddLambda([&DeferredCommands, ContextIndex]() { DeferredCommands.Replay(ContextIndex); });
 		}
 
 		FORCEINLINE bool CanTick() const { return PIEInstance < 0 || GEngine->GetWorldContextFromPIEInstance(PIEInstance); }
@@ -73,10 +89,12 @@ private:
 
 	struct FContextData
 	{
-		FContextData(const FString& ContextName, int32 ContextIndex, FSimpleMulticastDelegate& SharedDrawEvent, FImGuiDemo& Demo)
-			: ContextProxy(ContextName, &SharedDrawEvent)
+		FContextData(const FString& ContextName, int32 ContextIndex, FSimpleMulticastDelegate& SharedDrawEvent, FImGuiDemo& Demo,
+			FImGuiDeferredCommandQueue& DeferredCommands, FImGuiSharedFontAtlas& FontAtlas, ImGuiContext* PrewarmedContext)
+			: ContextProxy(ContextName, &SharedDrawEvent, FontAtlas, PrewarmedContext)
 		{
 			ContextProxy.OnDraw().AddLambda([&Demo, ContextIndex]() { Demo.DrawControls(ContextIndex); });
+			ContextProxy.OnDraw().AddLambda([&DeferredCommands, ContextIndex]() { DeferredCommands.Replay(ContextIndex); });
 		}
 
 		FORCEINLINE bool CanTick() const { return true; }
@@ -86,7 +104,25 @@ private:
 
 #endif // WITH_EDITOR
 
+	// Context from world mapping cached for worlds that are currently alive.
+	struct FWorldContextCacheEntry
+	{
+		const UWorld* World;
+		int32 ContextIndex;
+	};
+
 	void OnWorldTickStart(ELevelTick TickType, float DeltaSeconds);
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+	void OnPreWorldFinishDestroy(UWorld* World);
+
+	// Remove world from the cache, so it won't be matched with worlds that might be created at the same address.
+	void RemoveCachedWorld(const UWorld* World);
+
+	FORCEINLINE FContextData* FindContextData(int32 ContextIndex)
+	{
+		return Contexts.IsValidIndex(ContextIndex) ? Contexts[ContextIndex].Get() : nullptr;
+	}
 
 #if WITH_EDITOR
 	FContextData& GetEditorContextData();
@@ -98,9 +134,32 @@ private:
 
 	FContextData& GetWorldContextData(const UWorld& World, int32* OutContextIndex = nullptr);
 
-	TMap<int32, FContextData> Contexts;
+	FContextData& AddContextData(int32 Index, FContextData&& Data);
+
+	// Take a context from the pool of pre-warmed contexts or null, if pool is empty.
+	ImGuiContext* TakePrewarmedContext();
+
+	// Create pre-warmed contexts until the pool reaches its configured size.
+	void PrewarmContexts();
+
+	// Contexts addressed by their indices. Context data are allocated separately, so they keep their addresses when
+	// the table grows.
+	TArray<TUniquePtr<FContextData>> Contexts;
+
+	TArray<FWorldContextCacheEntry, TInlineAllocator<8>> WorldContextCache;
 
 	FImGuiDemo ImGuiDemo;
 
+	FImGuiSharedFontAtlas& FontAtlas;
+
+	FImGuiDeferredCommandQueue DeferredCommands;
+
+	// Contexts created in advance, so new proxies can be created without doing the expensive part of initialization.
+	TArray<ImGuiContext*> PrewarmedContexts;
+
+	// Pools of primitive draw lists, which unlike contexts, can be accessed from any thread.
+	TMap<int32, FImGuiPrimitiveDrawListsPtr> PrimitiveDrawLists;
+	FRWLock PrimitiveDrawListsLock;
+
 	FSimpleMulticastDelegate DrawMultiContextEvent;
 };
@@ -44,43 +44,68 @@ namespace
 	}
 }
 
-FImGuiContextProxy::FImGuiContextProxy(const FString& InName, FSimpleMulticastDelegate* InSharedDrawEvent)
-	: Name(InName)
-	, SharedDrawEvent(InSharedDrawEvent)
-	, IniFilename(TCHAR_TO_ANSI(*GetIniFile(InName)))
+ImGuiContext* FImGuiContextProxy::CreatePrewarmedContext(FImGuiSharedFontAtlas& FontAtlas)
 {
+	ImGuiContext* PreviousContext = ImGui::GetCurrentContext();
+
 	// Create context.
-	Context = TUniquePtr<ImGuiContext>(ImGui::CreateContext());
+	ImGuiContext* NewContext = ImGui::CreateContext();
 
 	// Set this context in ImGui for initialization (any allocations will be tracked in this context).
-	SetAsCurrent();
+	ImGui::SetCurrentContext(NewContext);
 
 	// Start initialization.
 	ImGuiIO& IO = ImGui::GetIO();
 
-	// Set session data storage.
-	IO.IniFilename = IniFilename.c_str();
-
 	// Use pre-defined canvas size.
 	IO.DisplaySize = { DEFAULT_CANVAS_WIDTH, DEFAULT_CANVAS_HEIGHT };
 
-	// When GetTexData is called for the first time it builds atlas texture and copies mouse cursor data to context.
-	// When multiple contexts share atlas then only the first one will get mouse data. A simple workaround is to use
-	// a temporary atlas if shared one is already built.
-	unsigned char* Pixels;
-	const bool bIsAltasBuilt = IO.Fonts->TexPixelsAlpha8 != nullptr;
-	if (bIsAltasBuilt)
-	{
-		ImFontAtlas().GetTexDataAsRGBA32(&Pixels, nullptr, nullptr);
-	}
-	else
-	{
-		IO.Fonts->GetTexDataAsRGBA32(&Pixels, nullptr, nullptr);
-	}
+	// Use shared font atlas. It is built only once, and mouse cursor data that ImGui generates during build are copied
+	// to every context.
+	FontAtlas.AddReference(*NewContext);
 
 	// Initialize key mapping, so context can correctly interpret input state.
 	ImGuiInterops::SetUnrealKeyMap(IO);
 
+	ImGui::SetCurrentContext(PreviousContext);
+
+	return NewContext;
+}
+
+void FImGuiContextProxy::DestroyPrewarmedContext(ImGuiContext* PrewarmedContext, FImGuiSharedFontAtlas& FontAtlas)
+{
+	if (PrewarmedContext)
+	{
+		FontAtlas.RemoveReference(*PrewarmedContext);
+
+		// Context was never used to start a frame, so there are no settings to save.
+		ImGuiContext* PreviousContext = ImGui::GetCurrentContext();
+		ImGui::SetCurrentContext(PrewarmedContext);
+		ImGui::DestroyContext(PrewarmedContext);
+		ImGui::SetCurrentContext(PreviousContext != PrewarmedContext ? PreviousContext : &ImGuiImplementation::GetDefaultContext());
+	}
+}
+
+FImGuiContextProxy::FImGuiContextProxy(const FString& InName, FSimpleMulticastDelegate* InSharedDrawEvent,
+	FImGuiSharedFontAtlas& InFontAtlas, ImGuiContext* PrewarmedContext)
+	: Name(InName)
+	, SharedDrawEvent(InSharedDrawEvent)
+	, FontAtlas(&InFontAtlas)
+	, IniFilename(TCHAR_TO_ANSI(*GetIniFile(InName)))
+{
+	// Use pre-warmed context or create a new one.
+	Context = TUniquePtr<ImGuiContext>(PrewarmedContext ? PrewarmedContext : CreatePrewarmedContext(InFontAtlas));
+
+	// Set this context in ImGui for initialization (any allocations will be tracked in this context).
+	SetAsCurrent();
+
+	// Create pool of primitive draw lists that share draw list data with this context.
+	PrimitiveDrawLists = MakeShared<FImGuiPrimitiveDrawLists, ESPMode::ThreadSafe>(ImGui::GetDrawListSharedData());
+
+	// Set session data storage. Settings are loaded when the first frame begins, so pre-warmed contexts get settings
+	// of this proxy.
+	ImGui::GetIO().IniFilename = IniFilename.c_str();
+
 	// Begin frame to complete context initialization (this is to avoid problems with other systems calling to ImGui
 	// during startup).
 	BeginFrame();
@@ -90,11 +115,14 @@ FImGuiContextProxy::~FImGuiContextProxy()
 {
 	if (Context)
 	{
+		WaitForFrameEnd();
+
 		// Set this context in ImGui for de-initialization (any de-allocations will be tracked in this context).
 		SetAsCurrent();
 
 		// Save context data and destroy.
 		ImGuiImplementation::SaveCurrentContextIniSettings(IniFilename.c_str());
+		FontAtlas->RemoveReference(*Context);
 		ImGui::DestroyContext(Context.Release());
 
 		// Set default context in ImGui to keep global context pointer valid.
@@ -104,6 +132,8 @@ FImGuiContextProxy::~FImGuiContextProxy()
 
 void FImGuiContextProxy::Draw()
 {
+	WaitForFrameEnd();
+
 	if (bIsFrameStarted && !bIsDrawCalled)
 	{
 		bIsDrawCalled = true;
@@ -130,30 +160,81 @@ void FImGuiContextProxy::Draw()
 
 void FImGuiContextProxy::Tick(float DeltaSeconds)
 {
+	if (PreTick())
+	{
+		TickFrame(DeltaSeconds);
+	}
+}
+
+bool FImGuiContextProxy::PreTick()
+{
+	// If frame is ending asynchronously, then we need to wait before we can start a new one.
+	WaitForFrameEnd();
+
 	// Making sure that we tick only once per frame.
 	if (LastFrameNumber < GFrameNumber)
 	{
 		LastFrameNumber = GFrameNumber;
 
-		SetAsCurrent();
+		// Make sure that draw events are called before the end of the frame. Listeners can access objects, so this
+		// needs to happen on the game thread.
+		Draw();
+
+		return true;
+	}
+
+	return false;
+}
+
+void FImGuiContextProxy::TickFrame(float DeltaSeconds)
+{
+	SetAsCurrent();
+
+	if (bIsFrameStarted)
+	{
+		// Ending frame will produce render output that we capture and store for later use. This also puts context to
+		// state in which it does not allow to draw controls, so we want to immediately start a new frame.
+		EndFrame();
+	}
+
+	// Update context information (some data, like mouse cursor, may be cleaned in new frame, so we should collect it
+	// beforehand).
+	bHasActiveItem = ImGui::IsAnyItemActive();
+	MouseCursor = ImGuiInterops::ToSlateMouseCursor(ImGui::GetMouseCursor());
+
+	// Begin a new frame and set the context back to a state in which it allows to draw controls.
+	BeginFrame(DeltaSeconds);
+}
+
+void FImGuiContextProxy::EndFrameAsync()
+{
+	if (bIsFrameStarted && !FrameEndTask.IsValid())
+	{
+		// Draw events can access objects, so they need to be called on the game thread.
+		Draw();
 
-		if (bIsFrameStarted)
+		FrameEndTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this]()
 		{
-			// Make sure that draw events are called before the end of the frame.
-			Draw();
+			SetAsCurrent();
 
-			// Ending frame will produce render output that we capture and store for later use. This also puts context to
-			// state in which it does not allow to draw controls, so we want to immediately start a new frame.
 			EndFrame();
-		}
 
-		// Update context information (some data, like mouse cursor, may be cleaned in new frame, so we should collect it
-		// beforehand).
-		bHasActiveItem = ImGui::IsAnyItemActive();
-		MouseCursor = ImGuiInterops::ToSlateMouseCursor(ImGui::GetMouseCursor());
+			// Collect the same information as the tick (see TickFrame).
+			bHasActiveItem = ImGui::IsAnyItemActive();
+			MouseCursor = ImGuiInterops::ToSlateMouseCursor(ImGui::GetMouseCursor());
 
-		// Begin a new frame and set the context back to a state in which it allows to draw controls.
-		BeginFrame(DeltaSeconds);
+			// Don't leave worker thread with pointer to context that might be destroyed.
+			ImGui::SetCurrentContext(&ImGuiImplementation::GetDefaultContext());
+		}, TStatId(), nullptr, ENamedThreads::AnyThread);
+	}
+}
+
+void FImGuiContextProxy::WaitForFrameEnd()
+{
+	if (FrameEndTask.IsValid())
+	{
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(FrameEndTask);
+		FrameEndTask.SafeRelease();
 	}
 }
 
@@ -191,15 +272,35 @@ void FImGuiContextProxy::EndFrame()
 	}
 }
 
-void FImGuiContextProxy::UpdateDrawData(ImDrawData* DrawData)
+void FImGuiContextProxy::UpdateDrawData(ImDrawData* ImGuiDrawData)
 {
-	if (DrawData && DrawData->CmdListsCount > 0)
+	// Write buffer contains data from older frames, which we can safely overwrite (this reuses their allocations).
+	TArray<FImGuiDrawList>& DrawLists = DrawData.GetWriteBuffer();
+
+	// Take primitive lists published since the last frame. Lists with negative layer keys are rendered below ImGui
+	// windows and the rest above them.
+	int32 NumBackgroundLists;
+	PrimitiveDrawLists->Acquire(AcquiredPrimitiveDrawLists, NumBackgroundLists);
+
+	const int32 NumImGuiLists = ImGuiDrawData ? ImGuiDrawData->CmdListsCount : 0;
+	const int32 NumLists = NumImGuiLists + AcquiredPrimitiveDrawLists.Num();
+
+	if (NumLists > 0)
 	{
-		DrawLists.SetNum(DrawData->CmdListsCount, false);
+		DrawLists.SetNum(NumLists, false);
 
-		for (int Index = 0; Index < DrawData->CmdListsCount; Index++)
+		int32 ListNb = 0;
+		for (int32 Index = 0; Index < NumBackgroundLists; Index++)
 		{
-			DrawLists[Index].TransferDrawData(*DrawData->CmdLists[Index]);
+			DrawLists[ListNb++].TransferDrawData(*AcquiredPrimitiveDrawLists[Index]);
+		}
+		for (int Index = 0; Index < NumImGuiLists; Index++)
+		{
+			DrawLists[ListNb++].TransferDrawData(*ImGuiDrawData->CmdLists[Index]);
+		}
+		for (int32 Index = NumBackgroundLists; Index < AcquiredPrimitiveDrawLists.Num(); Index++)
+		{
+			DrawLists[ListNb++].TransferDrawData(*AcquiredPrimitiveDrawLists[Index]);
 		}
 	}
 	else
@@ -207,4 +308,13 @@ void FImGuiContextProxy::UpdateDrawData(ImDrawData* DrawData)
 		// If we are not rendering then this might be a good moment to empty the array.
 		DrawLists.Empty();
 	}
+
+	// Transfer leaves lists cleared, so they can be reused.
+	PrimitiveDrawLists->Release(AcquiredPrimitiveDrawLists);
+
+	// Allow listeners to process data before they are published, on the same thread.
+	FrameEndedEvent.Broadcast(DrawLists);
+
+	// Make this frame data available to the consumer.
+	DrawData.Publish();
 }
@@ -3,7 +3,11 @@
 #pragma once
 
 #include "ImGuiDrawData.h"
+#include "ImGuiPrimitiveDrawLists.h"
+#include "ImGuiSharedFontAtlas.h"
+#include "Utilities/TripleBuffer.h"
 
+#include "Async/TaskGraphInterfaces.h"
 #include "GenericPlatform/ICursor.h"
 
 #include <imgui.h>
@@ -19,7 +23,21 @@ class FImGuiContextProxy
 {
 public:
 
-	FImGuiContextProxy(const FString& Name, FSimpleMulticastDelegate* InSharedDrawEvent);
+	// Create ImGui context and do the part of initialization which doesn't depend on a proxy. This allows to create
+	// contexts in advance and make proxy construction cheaper.
+	// @param FontAtlas - Font atlas shared by contexts
+	// @returns Context, which should be passed to a proxy constructor or destroyed with DestroyPrewarmedContext
+	static ImGuiContext* CreatePrewarmedContext(FImGuiSharedFontAtlas& FontAtlas);
+
+	// Destroy context created with CreatePrewarmedContext, which wasn't passed to any proxy.
+	static void DestroyPrewarmedContext(ImGuiContext* PrewarmedContext, FImGuiSharedFontAtlas& FontAtlas);
+
+	// @param Name - Name of this context, which also identifies file with its settings
+	// @param InSharedDrawEvent - Draw event shared by multiple contexts
+	// @param InFontAtlas - Font atlas shared by contexts (needs to outlive this proxy)
+	// @param PrewarmedContext - Context created with CreatePrewarmedContext for the same atlas or null to create a new one
+	FImGuiContextProxy(const FString& Name, FSimpleMulticastDelegate* InSharedDrawEvent, FImGuiSharedFontAtlas& InFontAtlas,
+		ImGuiContext* PrewarmedContext = nullptr);
 	~FImGuiContextProxy();
 
 	FImGuiContextProxy(const FImGuiContextProxy&) = delete;
@@ -31,8 +49,10 @@ public:
 	// Get the name of this context.
 	const FString& GetName() const { return Name; }
 
-	// Get draw data from the last frame.
-	const TArray<FImGuiDrawList>& GetDrawData() const { return DrawLists; }
+	// Get draw data from the last frame. Draw data are published as immutable snapshots, so this can be called from
+	// a different thread than the one that ticks this context, as long as it is always the same thread. Returned data
+	// stay valid until the next call. If frame is ending asynchronously, this waits for it to complete.
+	const TArray<FImGuiDrawList>& GetDrawData() { WaitForFrameEnd(); return DrawData.Acquire(); }
 
 	// Get input state used by this context.
 	const FImGuiInputState* GetInputState() const { return InputState; }
@@ -53,9 +73,20 @@ public:
 
 	EMouseCursor::Type GetMouseCursor() const { return MouseCursor;  }
 
+	// Get pool of draw lists in which any thread can emit primitives to be rendered with this context.
+	const FImGuiPrimitiveDrawListsPtr& GetPrimitiveDrawLists() const { return PrimitiveDrawLists; }
+
 	// Delegate called right before ending the frame to allows listeners draw their controls.
 	FSimpleMulticastDelegate& OnDraw() { return DrawEvent; }
 
+	DECLARE_MULTICAST_DELEGATE_OneParam(FFrameEndedEvent, const TArray<FImGuiDrawList>&);
+
+	// Delegate called after the frame is ended with new draw data, right before they are published. It is called on
+	// the thread that ends the frame, which in pipelined mode is a worker thread (see EndFrameAsync), so listeners
+	// should only access data which are not used by other threads until WaitForFrameEnd returns. Listeners should be
+	// added and removed after calling WaitForFrameEnd.
+	FFrameEndedEvent& OnFrameEnded() { return FrameEndedEvent; }
+
 	// Call draw events to allow listeners draw their widgets. Only one call per frame is processed. If it is not
 	// called manually before, then it will be called from the Tick function.
 	void Draw();
@@ -63,15 +94,34 @@ public:
 	// Tick to advance context to the next frame. Only one call per frame will be processed.
 	void Tick(float DeltaSeconds);
 
+	// First part of the tick, which should be called on the game thread. It makes sure that draw events are called
+	// before the end of the frame.
+	// @returns True, if context needs to advance to the next frame (only once per frame)
+	bool PreTick();
+
+	// Second part of the tick that advances context to the next frame. It doesn't call any delegates, so different
+	// contexts can be safely ticked in parallel. Should be only called when PreTick returns true.
+	void TickFrame(float DeltaSeconds);
+
+	// Call draw events and end the frame in a task, so rendering and transferring draw data can run in parallel with
+	// the rest of the game frame. Context cannot be used until the next tick starts a new frame and functions that
+	// need results of the task wait for it. Should be called on the game thread, after draw events can be called.
+	void EndFrameAsync();
+
+	// Wait until the frame ended by EndFrameAsync is complete. Should be called on the game thread.
+	void WaitForFrameEnd();
+
 private:
 
 	void BeginFrame(float DeltaTime = 1.f / 60.f);
 	void EndFrame();
 
-	void UpdateDrawData(ImDrawData* DrawData);
+	void UpdateDrawData(ImDrawData* ImGuiDrawData);
 
 	TUniquePtr<ImGuiContext> Context;
 
+	FImGuiSharedFontAtlas* FontAtlas = nullptr;
+
 	EMouseCursor::Type MouseCursor = EMouseCursor::None;
 	bool bHasActiveItem = false;
 
@@ -83,9 +133,19 @@ private:
 	FSimpleMulticastDelegate DrawEvent;
 	FSimpleMulticastDelegate* SharedDrawEvent = nullptr;
 
+	FFrameEndedEvent FrameEndedEvent;
+
+	// Task ending the frame in pipelined mode.
+	FGraphEventRef FrameEndTask;
+
 	const FImGuiInputState* InputState = nullptr;
 
-	TArray<FImGuiDrawList> DrawLists;
+	// Primitive draw lists are shared with other threads, which can keep them after this proxy is moved or destroyed.
+	FImGuiPrimitiveDrawListsPtr PrimitiveDrawLists;
+	TArray<ImDrawList*> AcquiredPrimitiveDrawLists;
+
+	// Draw data snapshots passed from ImGui frame updates to the consumer.
+	Utilities::TTripleBuffer<TArray<FImGuiDrawList>> DrawData;
 
 	FString Name;
 	std::string IniFilename;
@@ -0,0 +1,134 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#include "ImGuiDeferredCommandQueue.h"
+
+#include "ImGuiPrivatePCH.h"
+
+#include <HAL/PlatformAtomics.h>
+#include <Misc/ScopeLock.h>
+
+
+namespace
+{
+	// Source of queue identifiers. Starts from 1, so zero-initialized thread-local data never match any queue.
+	volatile int32 LastQueueId = 0;
+
+	// Buffer registered by the calling thread, together with identifier of the queue that owns it.
+	struct FThreadBufferCache
+	{
+		uint32 QueueId = 0;
+		void* Buffer = nullptr;
+	};
+
+	thread_local FThreadBufferCache ThreadBufferCache;
+
+	// Number of frames after which commands that were not replayed are dropped.
+	constexpr uint64 MaxPendingFrames = 60;
+}
+
+FImGuiDeferredCommandQueue::FImGuiDeferredCommandQueue()
+	: QueueId(static_cast<uint32>(FPlatformAtomics::InterlockedIncrement(&LastQueueId)))
+{
+}
+
+void FImGuiDeferredCommandQueue::Record(int32 ContextIndex, int32 SortKey, FImGuiDeferredCommand&& Command)
+{
+	FThreadBuffer& Buffer = GetThreadBuffer();
+	Buffer.Commands.Enqueue({ ContextIndex, SortKey, Buffer.ThreadNb, Buffer.NextSequence++, GFrameCounter, MoveTemp(Command) });
+}
+
+void FImGuiDeferredCommandQueue::Replay(int32 ContextIndex)
+{
+	check(IsInGameThread());
+
+	TArray<FRecordedCommand> Commands;
+	TakeCommands(ContextIndex, Commands);
+
+	// Keys are unique, so order is the same regardless of when commands were collected.
+	Commands.Sort([](const FRecordedCommand& Lhs, const FRecordedCommand& Rhs)
+	{
+		if (Lhs.SortKey != Rhs.SortKey)
+		{
+			return Lhs.SortKey < Rhs.SortKey;
+		}
+		if (Lhs.ThreadNb != Rhs.ThreadNb)
+		{
+			return Lhs.ThreadNb < Rhs.ThreadNb;
+		}
+		return Lhs.Sequence < Rhs.Sequence;
+	});
+
+	// Commands recorded during replay are collected during the next replay.
+	for (FRecordedCommand& Command : Commands)
+	{
+		if (Command.Command)
+		{
+			Command.Command();
+		}
+	}
+}
+
+void FImGuiDeferredCommandQueue::Discard(int32 ContextIndex)
+{
+	check(IsInGameThread());
+
+	TArray<FRecordedCommand> Commands;
+	TakeCommands(ContextIndex, Commands);
+}
+
+FImGuiDeferredCommandQueue::FThreadBuffer& FImGuiDeferredCommandQueue::GetThreadBuffer()
+{
+	FThreadBufferCache& Cache = ThreadBufferCache;
+	if (UNLIKELY(Cache.QueueId != QueueId))
+	{
+		// First command from this thread. Buffers are owned by the queue and stay valid after their threads exit.
+		FScopeLock Lock(&RegistrationLock);
+
+		TUniquePtr<FThreadBuffer>& Buffer = ThreadBuffers[ThreadBuffers.Add(MakeUnique<FThreadBuffer>())];
+		Buffer->ThreadNb = ThreadBuffers.Num() - 1;
+
+		Cache.QueueId = QueueId;
+		Cache.Buffer = Buffer.Get();
+	}
+
+	return *static_cast<FThreadBuffer*>(Cache.Buffer);
+}
+
+void FImGuiDeferredCommandQueue::CollectCommands()
+{
+	// Lock only protects the list of buffers from registrations. Buffers themselves are lock-free and this is their
+	// only consumer.
+	FScopeLock Lock(&RegistrationLock);
+
+	FRecordedCommand Command;
+	for (const TUniquePtr<FThreadBuffer>& Buffer : ThreadBuffers)
+	{
+		while (Buffer->Commands.Dequeue(Command))
+		{
+			PendingCommands.Add(MoveTemp(Command));
+		}
+	}
+}
+
+void FImGuiDeferredCommandQueue::TakeCommands(int32 ContextIndex, TArray<FRecordedCommand>& OutCommands)
+{
+	CollectCommands();
+
+	// Partition in one pass: commands for this context go to the output, commands for other contexts are kept, unless
+	// they expired.
+	TArray<FRecordedCommand> KeptCommands;
+	KeptCommands.Reserve(PendingCommands.Num());
+	for (FRecordedCommand& Command : PendingCommands)
+	{
+		if (Command.ContextIndex == ContextIndex)
+		{
+			OutCommands.Add(MoveTemp(Command));
+		}
+		else if (GFrameCounter - Command.Frame <= MaxPendingFrames)
+		{
+			KeptCommands.Add(MoveTemp(Command));
+		}
+	}
+
+	PendingCommands = MoveTemp(KeptCommands);
+}
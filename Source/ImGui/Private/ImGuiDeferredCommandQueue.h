@@ -0,0 +1,87 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#pragma once
+
+#include "ImGuiDeferredCommands.h"
+
+#include <Containers/Queue.h>
+#include <HAL/CriticalSection.h>
+
+
+// Queue for ImGui commands recorded on any thread and replayed on the game thread in target contexts.
+//
+// Every recording thread has its own single-producer buffer, so after the first command from a thread, which
+// registers its buffer, recording is lock-free and threads don't contend with each other. Buffers are drained on the
+// game thread during replay. Commands are ordered by sort key, then by the registration order of their threads and then
+// by the order in which they were recorded. Threads register in order of their first commands, so only the relative
+// order of commands with the same key recorded on different threads depends on timing.
+//
+// Commands that are not replayed within a limited number of frames (e.g. recorded for a context that doesn't tick)
+// are dropped.
+class FImGuiDeferredCommandQueue
+{
+public:
+
+	FImGuiDeferredCommandQueue();
+
+	FImGuiDeferredCommandQueue(const FImGuiDeferredCommandQueue&) = delete;
+	FImGuiDeferredCommandQueue& operator=(const FImGuiDeferredCommandQueue&) = delete;
+
+	FImGuiDeferredCommandQueue(FImGuiDeferredCommandQueue&&) = delete;
+	FImGuiDeferredCommandQueue& operator=(FImGuiDeferredCommandQueue&&) = delete;
+
+	// Record command to be replayed in context with given index. Can be called from any thread.
+	// @param ContextIndex - Index of the target context
+	// @param SortKey - Key defining replay order of commands (commands with lower keys are replayed first)
+	// @param Command - Command to record
+	void Record(int32 ContextIndex, int32 SortKey, FImGuiDeferredCommand&& Command);
+
+	// Replay all commands recorded for context with given index until now. Should be only called on the game thread,
+	// with the target context set as current.
+	// @param ContextIndex - Index of the context to which commands are replayed
+	void Replay(int32 ContextIndex);
+
+	// Drop all commands recorded for context with given index until now. Should be only called on the game thread.
+	// @param ContextIndex - Index of the context which commands should be dropped
+	void Discard(int32 ContextIndex);
+
+private:
+
+	struct FRecordedCommand
+	{
+		int32 ContextIndex;
+		int32 SortKey;
+		int32 ThreadNb;
+		uint32 Sequence;
+		uint64 Frame;
+		FImGuiDeferredCommand Command;
+	};
+
+	struct FThreadBuffer
+	{
+		TQueue<FRecordedCommand, EQueueMode::Spsc> Commands;
+		int32 ThreadNb = 0;
+		uint32 NextSequence = 0;
+	};
+
+	// Get buffer of the calling thread, registering it on the first call.
+	FThreadBuffer& GetThreadBuffer();
+
+	// Move all recorded commands from thread buffers to pending commands.
+	void CollectCommands();
+
+	// Collect recorded commands and move those for the given context to the output array. Expired commands for other
+	// contexts are dropped.
+	// @param ContextIndex - Index of the context which commands should be taken
+	// @param OutCommands - Array receiving commands for the context
+	void TakeCommands(int32 ContextIndex, TArray<FRecordedCommand>& OutCommands);
+
+	// Identifier of this queue used to validate thread-local buffer pointers.
+	const uint32 QueueId;
+
+	FCriticalSection RegistrationLock;
+	TArray<TUniquePtr<FThreadBuffer>> ThreadBuffers;
+
+	// Game thread state. Commands collected from thread buffers that wait for their contexts.
+	TArray<FRecordedCommand> PendingCommands;
+};
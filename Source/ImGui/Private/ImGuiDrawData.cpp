@@ -4,56 +4,307 @@
 
 #include "ImGuiPrivatePCH.h"
 
+#include <Async/ParallelFor.h>
 
-#if WITH_OBSOLETE_CLIPPING_API
-void FImGuiDrawList::CopyVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FVector2D VertexPositionOffset, const FSlateRotatedRect& VertexClippingRect) const
+// ARM targets define both PLATFORM_ENABLE_VECTORINTRINSICS and PLATFORM_ENABLE_VECTORINTRINSICS_NEON, so NEON needs
+// to be tested first (in the same way as in UnrealMathVectorCommon.h).
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+#define IMGUI_CONVERSION_NEON 1
+#define IMGUI_CONVERSION_SSE 0
+#elif PLATFORM_ENABLE_VECTORINTRINSICS
+#define IMGUI_CONVERSION_NEON 0
+#define IMGUI_CONVERSION_SSE 1
+#include <emmintrin.h>
 #else
-void FImGuiDrawList::CopyVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FVector2D VertexPositionOffset) const
-#endif // WITH_OBSOLETE_CLIPPING_API
+#define IMGUI_CONVERSION_NEON 0
+#define IMGUI_CONVERSION_SSE 0
+#endif
+
+
+namespace
 {
-	// Reset and reserve space in destination buffer.
-	OutVertexBuffer.SetNumUninitialized(ImGuiVertexBuffer.Size, false);
+	//====================================================================================================
+	// Conversion Kernels
+	//====================================================================================================
+
+#if IMGUI_USE_SLATE_VERTEX_LAYOUT
+
+	// ImGui is configured to use vertex layout compatible with Slate (see imconfig.h). Verify that it matches Slate
+	// vertex for this engine version.
+	static_assert(sizeof(ImDrawVert) == sizeof(FSlateVertex), "ImDrawVert and FSlateVertex have different sizes.");
+	static_assert(STRUCT_OFFSET(ImDrawVert, uv) == STRUCT_OFFSET(FSlateVertex, TexCoords), "ImDrawVert::uv doesn't match FSlateVertex::TexCoords.");
+	static_assert(STRUCT_OFFSET(ImDrawVert, uv_scale) == STRUCT_OFFSET(FSlateVertex, TexCoords) + 2 * sizeof(float), "ImDrawVert::uv_scale doesn't match FSlateVertex::TexCoords.");
+	static_assert(STRUCT_OFFSET(ImDrawVert, material_uv) == STRUCT_OFFSET(FSlateVertex, MaterialTexCoords), "ImDrawVert::material_uv doesn't match FSlateVertex::MaterialTexCoords.");
+	static_assert(STRUCT_OFFSET(ImDrawVert, pos) == STRUCT_OFFSET(FSlateVertex, Position), "ImDrawVert::pos doesn't match FSlateVertex::Position.");
+	static_assert(STRUCT_OFFSET(ImDrawVert, col) == STRUCT_OFFSET(FSlateVertex, Color), "ImDrawVert::col doesn't match FSlateVertex::Color.");
+	static_assert(STRUCT_OFFSET(ImDrawVert, pixel_size) == STRUCT_OFFSET(FSlateVertex, PixelSize), "ImDrawVert::pixel_size doesn't match FSlateVertex::PixelSize.");
+	static_assert(sizeof(ImVec2) == sizeof(FVector2D) && sizeof(ImU32) == sizeof(FColor), "ImGui and Unreal types have different sizes.");
+	static_assert(IM_COL32_R_SHIFT == 16 && IM_COL32_G_SHIFT == 8 && IM_COL32_B_SHIFT == 0 && IM_COL32_A_SHIFT == 24,
+		"ImGui colors need to be packed in the same way as FColor.");
+
+	// Copy vertices in a single block and complete data that ImGui doesn't write.
+	FORCEINLINE void ConvertVertices(FSlateVertex* RESTRICT Dst, const ImDrawVert* RESTRICT Src, int32 Num, const FVector2D& PositionOffset)
+	{
+		FMemory::Memcpy(Dst, Src, Num * sizeof(FSlateVertex));
+
+		if (PositionOffset.IsZero())
+		{
+			for (int32 Idx = 0; Idx < Num; Idx++)
+			{
+				Dst[Idx].TexCoords[2] = Dst[Idx].TexCoords[3] = 1.f;
+			}
+		}
+		else
+		{
+			for (int32 Idx = 0; Idx < Num; Idx++)
+			{
+				Dst[Idx].TexCoords[2] = Dst[Idx].TexCoords[3] = 1.f;
+				Dst[Idx].Position += PositionOffset;
+			}
+		}
+	}
+
+#else
+
+	// Vertex kernel loads position and UV with a single vector load, what requires them to be adjacent.
+	static_assert(STRUCT_OFFSET(ImDrawVert, uv) == STRUCT_OFFSET(ImDrawVert, pos) + sizeof(ImVec2),
+		"ImDrawVert layout is not compatible with vertex conversion kernel.");
+
+	// Convert vertices using Unreal vector intrinsics (SSE, NEON or FPU fallback depending on the platform).
+	FORCEINLINE void ConvertVertices(FSlateVertex* RESTRICT Dst, const ImDrawVert* RESTRICT Src, int32 Num, const FVector2D& PositionOffset)
+	{
+		const VectorRegister One = VectorOne();
+
+		for (int32 Idx = 0; Idx < Num; Idx++)
+		{
+			const ImDrawVert& ImGuiVertex = Src[Idx];
+			FSlateVertex& SlateVertex = Dst[Idx];
+
+			// Final UV is calculated in shader as XY * ZW, so we need set all components: [pos.x, pos.y, u, v] and
+			// [1, 1, 1, 1] are shuffled to [u, v, 1, 1].
+			const VectorRegister PosUV = VectorLoad(&ImGuiVertex.pos.x);
+			VectorStore(VectorShuffle(PosUV, One, 2, 3, 0, 1), SlateVertex.TexCoords);
+
+			// Copy ImGui position and add offset.
+			SlateVertex.Position[0] = ImGuiVertex.pos.x + PositionOffset.X;
+			SlateVertex.Position[1] = ImGuiVertex.pos.y + PositionOffset.Y;
+
+			// Unpack ImU32 color.
+			SlateVertex.Color = ImGuiInterops::UnpackImU32Color(ImGuiVertex.col);
+		}
+	}
+
+#endif // IMGUI_USE_SLATE_VERTEX_LAYOUT
+
+	// Scalar index conversion. Used as a fallback and to process elements remaining after vectorized loops.
+	template<typename DstType, typename SrcType>
+	FORCEINLINE void ConvertIndicesScalar(DstType* RESTRICT Dst, const SrcType* RESTRICT Src, int32 Num, int32 BaseVertex)
+	{
+		for (int32 Idx = 0; Idx < Num; Idx++)
+		{
+			Dst[Idx] = static_cast<DstType>(Src[Idx] - BaseVertex);
+		}
+	}
+
+	template<typename DstType, typename SrcType>
+	FORCEINLINE void ConvertIndices(DstType* RESTRICT Dst, const SrcType* RESTRICT Src, int32 Num, int32 BaseVertex)
+	{
+		ConvertIndicesScalar(Dst, Src, Num, BaseVertex);
+	}
+
+#if IMGUI_CONVERSION_SSE
+
+	// SSE2 kernel widening 16-bit ImGui indices to 32-bit Slate indices, 8 elements per iteration.
+	template<>
+	FORCEINLINE void ConvertIndices(uint32* RESTRICT Dst, const uint16* RESTRICT Src, int32 Num, int32 BaseVertex)
+	{
+		const __m128i Zero = _mm_setzero_si128();
+		const __m128i Base = _mm_set1_epi32(BaseVertex);
+
+		int32 Idx = 0;
+		for (; Idx + 8 <= Num; Idx += 8)
+		{
+			const __m128i Packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + Idx));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + Idx), _mm_sub_epi32(_mm_unpacklo_epi16(Packed, Zero), Base));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + Idx + 4), _mm_sub_epi32(_mm_unpackhi_epi16(Packed, Zero), Base));
+		}
+
+		ConvertIndicesScalar(Dst + Idx, Src + Idx, Num - Idx, BaseVertex);
+	}
+
+	// SSE2 kernel for 32-bit ImGui indices: a block copy or if indices need to be rebased, 8 elements per iteration.
+	FORCEINLINE void ConvertIndices(uint32* RESTRICT Dst, const uint32* RESTRICT Src, int32 Num, int32 BaseVertex)
+	{
+		if (BaseVertex == 0)
+		{
+			FMemory::Memcpy(Dst, Src, Num * sizeof(uint32));
+			return;
+		}
+
+		const __m128i Base = _mm_set1_epi32(BaseVertex);
+
+		int32 Idx = 0;
+		for (; Idx + 8 <= Num; Idx += 8)
+		{
+			const __m128i Low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + Idx));
+			const __m128i High = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + Idx + 4));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + Idx), _mm_sub_epi32(Low, Base));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + Idx + 4), _mm_sub_epi32(High, Base));
+		}
+
+		ConvertIndicesScalar(Dst + Idx, Src + Idx, Num - Idx, BaseVertex);
+	}
+
+#elif IMGUI_CONVERSION_NEON
+
+	// NEON kernel widening 16-bit ImGui indices to 32-bit Slate indices, 8 elements per iteration.
+	template<>
+	FORCEINLINE void ConvertIndices(uint32* RESTRICT Dst, const uint16* RESTRICT Src, int32 Num, int32 BaseVertex)
+	{
+		const uint32x4_t Base = vdupq_n_u32(static_cast<uint32>(BaseVertex));
+
+		int32 Idx = 0;
+		for (; Idx + 8 <= Num; Idx += 8)
+		{
+			const uint16x8_t Packed = vld1q_u16(Src + Idx);
+			vst1q_u32(Dst + Idx, vsubq_u32(vmovl_u16(vget_low_u16(Packed)), Base));
+			vst1q_u32(Dst + Idx + 4, vsubq_u32(vmovl_u16(vget_high_u16(Packed)), Base));
+		}
 
-	// Transform and copy vertex data.
-	for (int Idx = 0; Idx < ImGuiVertexBuffer.Size; Idx++)
+		ConvertIndicesScalar(Dst + Idx, Src + Idx, Num - Idx, BaseVertex);
+	}
+
+	// NEON kernel for 32-bit ImGui indices: a block copy or if indices need to be rebased, 8 elements per iteration.
+	FORCEINLINE void ConvertIndices(uint32* RESTRICT Dst, const uint32* RESTRICT Src, int32 Num, int32 BaseVertex)
+	{
+		if (BaseVertex == 0)
+		{
+			FMemory::Memcpy(Dst, Src, Num * sizeof(uint32));
+			return;
+		}
+
+		const uint32x4_t Base = vdupq_n_u32(static_cast<uint32>(BaseVertex));
+
+		int32 Idx = 0;
+		for (; Idx + 8 <= Num; Idx += 8)
+		{
+			vst1q_u32(Dst + Idx, vsubq_u32(vld1q_u32(Src + Idx), Base));
+			vst1q_u32(Dst + Idx + 4, vsubq_u32(vld1q_u32(Src + Idx + 4), Base));
+		}
+
+		ConvertIndicesScalar(Dst + Idx, Src + Idx, Num - Idx, BaseVertex);
+	}
+
+#endif // IMGUI_CONVERSION_SSE
+
+	//====================================================================================================
+	// Content Hashing
+	//====================================================================================================
+
+	// FNV-1a variant that consumes 32-bit words. It is not a strong hash, but it is cheap and good enough to detect
+	// whether draw data changed between frames.
+	constexpr uint64 HashOffsetBasis = 0xcbf29ce484222325ull;
+	constexpr uint64 HashPrime = 0x100000001b3ull;
+
+	FORCEINLINE uint64 HashWord(uint64 Hash, uint32 Word)
 	{
-		const ImDrawVert& ImGuiVertex = ImGuiVertexBuffer[Idx];
-		FSlateVertex& SlateVertex = OutVertexBuffer[Idx];
+		return (Hash ^ Word) * HashPrime;
+	}
 
-		// Final UV is calculated in shader as XY * ZW, so we need set all components.
-		SlateVertex.TexCoords[0] = ImGuiVertex.uv.x;
-		SlateVertex.TexCoords[1] = ImGuiVertex.uv.y;
-		SlateVertex.TexCoords[2] = SlateVertex.TexCoords[3] = 1.f;
+	FORCEINLINE uint64 HashFloat(uint64 Hash, float Value)
+	{
+		uint32 Word;
+		FMemory::Memcpy(&Word, &Value, sizeof(Word));
+		return HashWord(Hash, Word);
+	}
+
+	FORCEINLINE uint64 HashPointer(uint64 Hash, const void* Ptr)
+	{
+		const uint64 Value = static_cast<uint64>(reinterpret_cast<UPTRINT>(Ptr));
+		return HashWord(HashWord(Hash, static_cast<uint32>(Value)), static_cast<uint32>(Value >> 32));
+	}
+
+	// Same-size indices without offset can be copied directly.
+	template<typename IndexType>
+	FORCEINLINE void ConvertIndices(IndexType* RESTRICT Dst, const IndexType* RESTRICT Src, int32 Num, int32 BaseVertex)
+	{
+		if (BaseVertex == 0)
+		{
+			FMemory::Memcpy(Dst, Src, Num * sizeof(IndexType));
+		}
+		else
+		{
+			ConvertIndicesScalar(Dst, Src, Num, BaseVertex);
+		}
+	}
+}
 
-		// Copy ImGui position and add offset.
-		SlateVertex.Position[0] = ImGuiVertex.pos.x + VertexPositionOffset.X;
-		SlateVertex.Position[1] = ImGuiVertex.pos.y + VertexPositionOffset.Y;
 
 #if WITH_OBSOLETE_CLIPPING_API
-		// Set clipping rectangle.
-		SlateVertex.ClipRect = VertexClippingRect;
+void FImGuiDrawList::CopyGeometryData(const Utilities::TRange<int32>& VertexRange, const ImDrawIdx* Indices, const int32 NumElements,
+	FSlateVertex* OutVertices, SlateIndex* OutIndices, const int32 FirstVertex, const FVector2D VertexPositionOffset,
+	const FSlateRotatedRect& VertexClippingRect) const
+#else
+void FImGuiDrawList::CopyGeometryData(const Utilities::TRange<int32>& VertexRange, const ImDrawIdx* Indices, const int32 NumElements,
+	FSlateVertex* OutVertices, SlateIndex* OutIndices, const int32 FirstVertex, const FVector2D VertexPositionOffset) const
 #endif // WITH_OBSOLETE_CLIPPING_API
+{
+	checkf(VertexRange.GetBegin() >= 0 && VertexRange.GetEnd() <= ImGuiVertexBuffer.Size, TEXT("Vertex range out of bounds."));
+
+	const int32 NumVertices = VertexRange.GetEnd() - VertexRange.GetBegin();
+	ConvertVertices(OutVertices, ImGuiVertexBuffer.Data + VertexRange.GetBegin(), NumVertices, VertexPositionOffset);
 
-		// Unpack ImU32 color.
-		SlateVertex.Color = ImGuiInterops::UnpackImU32Color(ImGuiVertex.col);
+#if WITH_OBSOLETE_CLIPPING_API
+	for (int32 Idx = 0; Idx < NumVertices; Idx++)
+	{
+		OutVertices[Idx].ClipRect = VertexClippingRect;
 	}
+#endif // WITH_OBSOLETE_CLIPPING_API
+
+	// Indices are rebased from the vertex range to its position in the destination buffer.
+	ConvertIndices(OutIndices, Indices, NumElements, VertexRange.GetBegin() - FirstVertex);
 }
 
-void FImGuiDrawList::CopyIndexData(TArray<SlateIndex>& OutIndexBuffer, const int32 StartIndex, const int32 NumElements) const
+int32 FImGuiDrawList::CullTriangles(const int32 StartIndex, const int32 NumElements, const FSlateRect& CullingRect,
+	TArray<ImDrawIdx>& OutIndices, Utilities::TRange<int32>& OutVertexRange) const
 {
-	// Reset buffer.
-	OutIndexBuffer.SetNumUninitialized(NumElements, false);
+	checkf(StartIndex >= 0 && StartIndex + NumElements <= ImGuiIndexBuffer.Size, TEXT("Index range out of bounds."));
 
-	// Copy elements (slow copy because of different sizes of ImDrawIdx and SlateIndex and because SlateIndex can
-	// have different size on different platforms).
-	for (int i = 0; i < NumElements; i++)
+	const int32 InitialNum = OutIndices.Num();
+	OutVertexRange.SetEmpty();
+
+	const ImDrawIdx* Indices = ImGuiIndexBuffer.Data + StartIndex;
+	for (int32 Idx = 0; Idx + 3 <= NumElements; Idx += 3)
 	{
-		OutIndexBuffer[i] = ImGuiIndexBuffer[StartIndex + i];
+		const ImVec2& A = ImGuiVertexBuffer[Indices[Idx]].pos;
+		const ImVec2& B = ImGuiVertexBuffer[Indices[Idx + 1]].pos;
+		const ImVec2& C = ImGuiVertexBuffer[Indices[Idx + 2]].pos;
+
+		// Keep triangles with bounds touching the culling rectangle. This is conservative, but it removes the bulk
+		// of geometry in windows that are partially outside of the clipping rectangle.
+		if (FMath::Max3(A.x, B.x, C.x) >= CullingRect.Left && FMath::Min3(A.x, B.x, C.x) <= CullingRect.Right
+			&& FMath::Max3(A.y, B.y, C.y) >= CullingRect.Top && FMath::Min3(A.y, B.y, C.y) <= CullingRect.Bottom)
+		{
+			OutIndices.Append(Indices + Idx, 3);
+			OutVertexRange.AddPosition(Indices[Idx]);
+			OutVertexRange.AddPosition(Indices[Idx + 1]);
+			OutVertexRange.AddPosition(Indices[Idx + 2]);
+		}
 	}
+
+	return OutIndices.Num() - InitialNum;
+}
+
+void FImGuiDrawList::AppendRawData(TArray<ImDrawVert>& OutVertexBuffer, TArray<ImDrawIdx>& OutIndexBuffer) const
+{
+	OutVertexBuffer.Append(ImGuiVertexBuffer.Data, ImGuiVertexBuffer.Size);
+	OutIndexBuffer.Append(ImGuiIndexBuffer.Data, ImGuiIndexBuffer.Size);
 }
 
 void FImGuiDrawList::TransferDrawData(ImDrawList& Src)
 {
+	SourceId = reinterpret_cast<UPTRINT>(&Src);
+
 	// Move data from source to this list.
 	Src.CmdBuffer.swap(ImGuiCommandBuffer);
 	Src.IdxBuffer.swap(ImGuiIndexBuffer);
@@ -62,4 +313,310 @@ void FImGuiDrawList::TransferDrawData(ImDrawList& Src)
 	// ImGui seems to clear draw lists in every frame, but since source list can contain pointers to buffers that
 	// we just swapped, it is better to clear explicitly here.
 	Src.Clear();
+
+	// Find vertices addressed by each command. ImGui appends vertices for the current command, so ranges are typically
+	// disjoint and this allows to convert and submit every vertex only once, no matter how many commands are in the list.
+	VertexRanges.SetNum(ImGuiCommandBuffer.Size, false);
+
+	int32 IndexOffset = 0;
+	for (int CommandNb = 0; CommandNb < ImGuiCommandBuffer.Size; CommandNb++)
+	{
+		const int32 NumElements = ImGuiCommandBuffer[CommandNb].ElemCount;
+
+		Utilities::TRange<int32>& VertexRange = VertexRanges[CommandNb];
+		VertexRange.SetEmpty();
+		for (int32 Idx = IndexOffset; Idx < IndexOffset + NumElements; Idx++)
+		{
+			VertexRange.AddPosition(ImGuiIndexBuffer[Idx]);
+		}
+
+		IndexOffset += NumElements;
+	}
+
+	// Hash content, so we can detect when it doesn't change between frames. Vertices are hashed by fields, because
+	// depending on the configured layout, they can contain data that ImGui doesn't initialize.
+	uint64 Hash = HashOffsetBasis;
+	for (const ImDrawCmd& Command : ImGuiCommandBuffer)
+	{
+		Hash = HashWord(Hash, Command.ElemCount);
+		Hash = HashFloat(Hash, Command.ClipRect.x);
+		Hash = HashFloat(Hash, Command.ClipRect.y);
+		Hash = HashFloat(Hash, Command.ClipRect.z);
+		Hash = HashFloat(Hash, Command.ClipRect.w);
+		Hash = HashPointer(Hash, Command.TextureId);
+	}
+	for (const ImDrawVert& Vertex : ImGuiVertexBuffer)
+	{
+		Hash = HashFloat(Hash, Vertex.pos.x);
+		Hash = HashFloat(Hash, Vertex.pos.y);
+		Hash = HashFloat(Hash, Vertex.uv.x);
+		Hash = HashFloat(Hash, Vertex.uv.y);
+		Hash = HashWord(Hash, Vertex.col);
+	}
+	for (const ImDrawIdx Index : ImGuiIndexBuffer)
+	{
+		Hash = HashWord(Hash, Index);
+	}
+	ContentHash = Hash;
+
+	// Find bounds of vertices addressed by each command. Those are used to detect whether clipping rectangles have
+	// any effect on commands and to skip them when merging commands into batches.
+	CommandBounds.SetNum(ImGuiCommandBuffer.Size, false);
+
+	for (int CommandNb = 0; CommandNb < ImGuiCommandBuffer.Size; CommandNb++)
+	{
+		const Utilities::TRange<int32>& VertexRange = VertexRanges[CommandNb];
+		FSlateRect& Bounds = CommandBounds[CommandNb];
+
+		if (VertexRange.IsEmpty())
+		{
+			Bounds = FSlateRect{};
+			continue;
+		}
+
+		const ImVec2& FirstPosition = ImGuiVertexBuffer[VertexRange.GetBegin()].pos;
+		Bounds = FSlateRect{ FirstPosition.x, FirstPosition.y, FirstPosition.x, FirstPosition.y };
+		for (int32 Idx = VertexRange.GetBegin() + 1; Idx < VertexRange.GetEnd(); Idx++)
+		{
+			const ImVec2& Position = ImGuiVertexBuffer[Idx].pos;
+			Bounds.Left = FMath::Min(Bounds.Left, Position.x);
+			Bounds.Top = FMath::Min(Bounds.Top, Position.y);
+			Bounds.Right = FMath::Max(Bounds.Right, Position.x);
+			Bounds.Bottom = FMath::Max(Bounds.Bottom, Position.y);
+		}
+	}
+}
+
+
+namespace
+{
+	FORCEINLINE bool ContainsRect(const FSlateRect& Outer, const FSlateRect& Inner)
+	{
+		return Inner.Left >= Outer.Left && Inner.Top >= Outer.Top && Inner.Right <= Outer.Right && Inner.Bottom <= Outer.Bottom;
+	}
+
+	FORCEINLINE bool Intersects(const FSlateRect& A, const FSlateRect& B)
+	{
+		return A.Left <= B.Right && B.Left <= A.Right && A.Top <= B.Bottom && B.Top <= A.Bottom;
+	}
+
+	FORCEINLINE bool IsEmpty(const FSlateRect& Rect)
+	{
+		return Rect.Right <= Rect.Left || Rect.Bottom <= Rect.Top;
+	}
+
+	FORCEINLINE FSlateRect UnionWith(const FSlateRect& A, const FSlateRect& B)
+	{
+		return FSlateRect{ FMath::Min(A.Left, B.Left), FMath::Min(A.Top, B.Top), FMath::Max(A.Right, B.Right), FMath::Max(A.Bottom, B.Bottom) };
+	}
+}
+
+uint64 FImGuiSlateDrawData::ComputeDrawDataHash(const TArray<FImGuiDrawList>& DrawLists)
+{
+	uint64 Hash = HashWord(HashOffsetBasis, DrawLists.Num());
+	for (const FImGuiDrawList& DrawList : DrawLists)
+	{
+		const uint64 ListHash = DrawList.GetContentHash();
+		Hash = HashWord(HashWord(Hash, static_cast<uint32>(ListHash)), static_cast<uint32>(ListHash >> 32));
+	}
+	return Hash;
+}
+
+bool FImGuiSlateDrawData::UpdateWithLastParameters(const TArray<FImGuiDrawList>& DrawLists, bool bParallel)
+{
+	if (!bHasConvertedData)
+	{
+		return false;
+	}
+
+	// Copy parameters, because update overwrites them.
+	const FSlateRect ClippingRect = ConvertedClippingRect;
+	return Update(DrawLists, ConvertedVertexPositionOffset, ClippingRect, bParallel, bConvertedWithCulling);
+}
+
+bool FImGuiSlateDrawData::Update(const TArray<FImGuiDrawList>& DrawLists, const FVector2D VertexPositionOffset,
+	const FSlateRect& WidgetClippingRect, bool bParallel, bool bCullTriangles)
+{
+	// If ImGui output is the same as in the last update, we can reuse already converted batches.
+	const uint64 NewDrawDataHash = ComputeDrawDataHash(DrawLists);
+	if (bHasConvertedData && NewDrawDataHash == DrawDataHash && VertexPositionOffset == ConvertedVertexPositionOffset
+		&& WidgetClippingRect == ConvertedClippingRect && bCullTriangles == bConvertedWithCulling)
+	{
+		return false;
+	}
+
+	DrawDataHash = NewDrawDataHash;
+	ConvertedVertexPositionOffset = VertexPositionOffset;
+	ConvertedClippingRect = WidgetClippingRect;
+	bConvertedWithCulling = bCullTriangles;
+	bHasConvertedData = true;
+
+	Segments.Reset();
+	CulledIndices.Reset();
+
+	// State of the batch that is currently built.
+	int32 NumBatches = 0;
+	TextureIndex BatchTexture = TextureIndex{};
+	FSlateRect BatchClippingRect, BatchBounds;
+	int32 BatchNumVertices = 0, BatchNumIndices = 0;
+
+	auto CloseBatch = [&]()
+	{
+		if (NumBatches > 0)
+		{
+			FImGuiSlateDrawCommand& Batch = Batches[NumBatches - 1];
+			Batch.VertexBuffer.SetNumUninitialized(BatchNumVertices, false);
+			Batch.IndexBuffer.SetNumUninitialized(BatchNumIndices, false);
+			Batch.ClippingRect = BatchClippingRect;
+			Batch.TextureId = BatchTexture;
+		}
+	};
+
+	for (int32 ListNb = 0; ListNb < DrawLists.Num(); ListNb++)
+	{
+		const FImGuiDrawList& DrawList = DrawLists[ListNb];
+
+		int32 StartIndex = 0;
+		for (int CommandNb = 0; CommandNb < DrawList.NumCommands(); CommandNb++)
+		{
+			const FImGuiDrawCommand& DrawCommand = DrawList.GetCommand(CommandNb);
+
+			// Advance before command is merged, so all paths below see its start index and the next command gets its own.
+			const int32 CommandStartIndex = StartIndex;
+			StartIndex += DrawCommand.NumElements;
+
+			if (DrawCommand.NumElements == 0)
+			{
+				continue;
+			}
+
+			// Transform clipping rectangle and bounds to target space.
+			const FSlateRect ClippingRect = DrawCommand.ClippingRect.OffsetBy(WidgetClippingRect.GetTopLeft()).IntersectionWith(WidgetClippingRect);
+			const FSlateRect Bounds = DrawCommand.Bounds.OffsetBy(VertexPositionOffset);
+
+			// Skip commands that would be completely clipped, like windows outside of the widget or scrolled out content.
+			if (IsEmpty(ClippingRect) || !Intersects(ClippingRect, Bounds))
+			{
+				continue;
+			}
+
+			// If geometry of the command is inside of its clipping rectangle, then clipping doesn't have any effect and
+			// command can be clipped by the widget rectangle instead. This is typical for most of the window content and
+			// allows to merge commands that ImGui split to change clipping.
+			const bool bClipped = !ContainsRect(ClippingRect, Bounds);
+			const FSlateRect& EffectiveClippingRect = bClipped ? ClippingRect : WidgetClippingRect;
+
+			Utilities::TRange<int32> VertexRange = DrawCommand.VertexRange;
+			int32 SegmentStartIndex = CommandStartIndex;
+			int32 NumElements = DrawCommand.NumElements;
+			bool bCulled = false;
+
+			// Optionally remove triangles that would be clipped, so their vertices are never converted or submitted.
+			if (bCullTriangles && bClipped)
+			{
+				SegmentStartIndex = CulledIndices.Num();
+				NumElements = DrawList.CullTriangles(CommandStartIndex, DrawCommand.NumElements,
+					ClippingRect.OffsetBy(-VertexPositionOffset), CulledIndices, VertexRange);
+				bCulled = true;
+
+				if (NumElements == 0)
+				{
+					continue;
+				}
+			}
+
+			const int32 NumVertices = VertexRange.GetEnd() - VertexRange.GetBegin();
+
+			// Merged batch must be still addressable with Slate indices.
+			const bool bCanAddVertices = static_cast<int64>(BatchNumVertices) + NumVertices - 1 <= static_cast<int64>(TNumericLimits<SlateIndex>::Max());
+
+			bool bMerge = false;
+			if (NumBatches > 0 && DrawCommand.TextureId == BatchTexture && bCanAddVertices)
+			{
+				if (EffectiveClippingRect == BatchClippingRect)
+				{
+					bMerge = true;
+				}
+				else if (EffectiveClippingRect == WidgetClippingRect && ContainsRect(BatchClippingRect, Bounds))
+				{
+					// Command is not clipped and batch clipping won't affect it.
+					bMerge = true;
+				}
+				else if (BatchClippingRect == WidgetClippingRect && ContainsRect(EffectiveClippingRect, BatchBounds))
+				{
+					// Batch is not clipped and command clipping won't affect it, so we can use it for the whole batch.
+					BatchClippingRect = EffectiveClippingRect;
+					bMerge = true;
+				}
+			}
+
+			if (bMerge)
+			{
+				BatchBounds = UnionWith(BatchBounds, Bounds);
+			}
+			else
+			{
+				CloseBatch();
+
+				if (NumBatches == Batches.Num())
+				{
+					Batches.AddDefaulted();
+				}
+				NumBatches++;
+
+				BatchTexture = DrawCommand.TextureId;
+				BatchClippingRect = EffectiveClippingRect;
+				BatchBounds = Bounds;
+				BatchNumVertices = 0;
+				BatchNumIndices = 0;
+			}
+
+			Segments.Add({ ListNb, VertexRange, SegmentStartIndex, NumElements, bCulled, NumBatches - 1, BatchNumVertices, BatchNumIndices });
+
+			BatchNumVertices += NumVertices;
+			BatchNumIndices += NumElements;
+		}
+	}
+
+	CloseBatch();
+
+	// Release batches that are not used in this frame.
+	Batches.SetNum(NumBatches, false);
+
+#if WITH_OBSOLETE_CLIPPING_API
+	// Convert clipping rectangle to format required by Slate vertex.
+	const FSlateRotatedRect VertexClippingRect{ WidgetClippingRect };
+#endif // WITH_OBSOLETE_CLIPPING_API
+
+	// Every segment has its own part of the batch buffers, so they can be converted independently.
+	auto ConvertSegment = [&](int32 SegmentNb)
+	{
+		const FSegment& Segment = Segments[SegmentNb];
+		FImGuiSlateDrawCommand& Batch = Batches[Segment.BatchNb];
+
+		const FImGuiDrawList& DrawList = DrawLists[Segment.ListNb];
+		const ImDrawIdx* Indices = Segment.bCulled ? CulledIndices.GetData() + Segment.StartIndex : DrawList.GetIndices(Segment.StartIndex);
+
+		DrawList.CopyGeometryData(Segment.VertexRange, Indices, Segment.NumElements,
+			Batch.VertexBuffer.GetData() + Segment.BatchVertexOffset, Batch.IndexBuffer.GetData() + Segment.BatchIndexOffset,
+#if WITH_OBSOLETE_CLIPPING_API
+			Segment.BatchVertexOffset, VertexPositionOffset, VertexClippingRect);
+#else
+			Segment.BatchVertexOffset, VertexPositionOffset);
+#endif // WITH_OBSOLETE_CLIPPING_API
+	};
+
+	if (bParallel)
+	{
+		ParallelFor(Segments.Num(), ConvertSegment);
+	}
+	else
+	{
+		for (int32 SegmentNb = 0; SegmentNb < Segments.Num(); SegmentNb++)
+		{
+			ConvertSegment(SegmentNb);
+		}
+	}
+
+	return true;
 }
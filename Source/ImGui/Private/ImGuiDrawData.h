@@ -3,6 +3,7 @@
 #pragma once
 
 #include "ImGuiInteroperability.h"
+#include "Utilities/Range.h"
 
 #include "Runtime/Launch/Resources/Version.h"
 #include "Rendering/RenderingCommon.h"
@@ -20,6 +21,21 @@ struct FImGuiDrawCommand
 	uint32 NumElements;
 	FSlateRect ClippingRect;
 	TextureIndex TextureId;
+
+	// Range of vertices addressed by this command (only those need to be converted and submitted to Slate).
+	Utilities::TRange<int32> VertexRange;
+
+	// Bounds of vertices addressed by this command, in ImGui space.
+	FSlateRect Bounds;
+};
+
+// One or more ImGui draw commands converted to Slate buffers, ready to be submitted as a custom verts element.
+struct FImGuiSlateDrawCommand
+{
+	TArray<FSlateVertex> VertexBuffer;
+	TArray<SlateIndex> IndexBuffer;
+	FSlateRect ClippingRect;
+	TextureIndex TextureId;
 };
 
 // Wraps raw ImGui draw list data in utilities that transform them for Slate.
@@ -36,28 +52,69 @@ public:
 	FORCEINLINE FImGuiDrawCommand GetCommand(int CommandNb) const
 	{
 		const ImDrawCmd& ImGuiCommand = ImGuiCommandBuffer[CommandNb];
-		return{ ImGuiCommand.ElemCount, ImGuiInterops::ToSlateRect(ImGuiCommand.ClipRect), ImGuiInterops::ToTextureIndex(ImGuiCommand.TextureId) };
+		return{ ImGuiCommand.ElemCount, ImGuiInterops::ToSlateRect(ImGuiCommand.ClipRect), ImGuiInterops::ToTextureIndex(ImGuiCommand.TextureId),
+			VertexRanges[CommandNb], CommandBounds[CommandNb] };
 	}
 
+	// Get pointer to index data of this list.
+	// @param StartIndex - Position of the first element
+	FORCEINLINE const ImDrawIdx* GetIndices(int32 StartIndex) const { return ImGuiIndexBuffer.Data + StartIndex; }
+
 #if WITH_OBSOLETE_CLIPPING_API
-	// Transform and copy vertex data to target buffer (old data in the target buffer are replaced).
-	// @param OutVertexBuffer - Destination buffer
+	// Transform and copy a range of vertices and indices addressing them to target memory.
+	// @param VertexRange - Range of vertices to copy
+	// @param Indices - Source indices, from this list (see GetIndices) or derived from them (see CullTriangles)
+	// @param NumElements - How many elements we want to copy
+	// @param OutVertices - Destination vertex memory, with enough space for all vertices in the range
+	// @param OutIndices - Destination index memory, with enough space for all elements
+	// @param FirstVertex - Position of the first copied vertex in the destination buffer (copied indices are rebased to it)
 	// @param VertexPositionOffset - Position offset added to every vertex to transform it to different space
 	// @param VertexClippingRect - Clipping rectangle for Slate vertices
-	void CopyVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FVector2D VertexPositionOffset, const FSlateRotatedRect& VertexClippingRect) const;
+	void CopyGeometryData(const Utilities::TRange<int32>& VertexRange, const ImDrawIdx* Indices, const int32 NumElements,
+		FSlateVertex* OutVertices, SlateIndex* OutIndices, const int32 FirstVertex, const FVector2D VertexPositionOffset,
+		const FSlateRotatedRect& VertexClippingRect) const;
 #else
-	// Transform and copy vertex data to target buffer (old data in the target buffer are replaced).
-	// @param OutVertexBuffer - Destination buffer
+	// Transform and copy a range of vertices and indices addressing them to target memory.
+	// @param VertexRange - Range of vertices to copy
+	// @param Indices - Source indices, from this list (see GetIndices) or derived from them (see CullTriangles)
+	// @param NumElements - How many elements we want to copy
+	// @param OutVertices - Destination vertex memory, with enough space for all vertices in the range
+	// @param OutIndices - Destination index memory, with enough space for all elements
+	// @param FirstVertex - Position of the first copied vertex in the destination buffer (copied indices are rebased to it)
 	// @param VertexPositionOffset - Position offset added to every vertex to transform it to different space
-	void CopyVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FVector2D VertexPositionOffset) const;
+	void CopyGeometryData(const Utilities::TRange<int32>& VertexRange, const ImDrawIdx* Indices, const int32 NumElements,
+		FSlateVertex* OutVertices, SlateIndex* OutIndices, const int32 FirstVertex, const FVector2D VertexPositionOffset) const;
 #endif // WITH_OBSOLETE_CLIPPING_API
 
-	// Transform and copy index data to target buffer (old data in the target buffer are replaced).
-	// Internal index buffer contains enough data to match the sum of NumElements from all draw commands.
-	// @param OutIndexBuffer - Destination buffer
-	// @param StartIndex - Start copying source data starting from this index
-	// @param NumElements - How many elements we want to copy
-	void CopyIndexData(TArray<SlateIndex>& OutIndexBuffer, const int32 StartIndex, const int32 NumElements) const;
+	// Find triangles that intersect with the culling rectangle and append their indices to target buffer.
+	// @param StartIndex - Position of the first element to test
+	// @param NumElements - Number of elements to test
+	// @param CullingRect - Culling rectangle in ImGui space
+	// @param OutIndices - Destination buffer
+	// @param OutVertexRange - Range of vertices addressed by appended indices
+	// @returns Number of appended elements
+	int32 CullTriangles(const int32 StartIndex, const int32 NumElements, const FSlateRect& CullingRect,
+		TArray<ImDrawIdx>& OutIndices, Utilities::TRange<int32>& OutVertexRange) const;
+
+	// Get the number of vertices in this list.
+	FORCEINLINE int NumVertices() const { return ImGuiVertexBuffer.Size; }
+
+	// Get the number of indices in this list.
+	FORCEINLINE int NumIndices() const { return ImGuiIndexBuffer.Size; }
+
+	// Append raw vertex and index data to target buffers, without any transformation (for renderers that consume data
+	// in ImGui format).
+	// @param OutVertexBuffer - Destination vertex buffer
+	// @param OutIndexBuffer - Destination index buffer
+	void AppendRawData(TArray<ImDrawVert>& OutVertexBuffer, TArray<ImDrawIdx>& OutIndexBuffer) const;
+
+	// Get hash of the draw list content calculated during transfer. Lists with identical commands, vertices and indices
+	// have the same hash, what allows to detect frames where ImGui output didn't change.
+	FORCEINLINE uint64 GetContentHash() const { return ContentHash; }
+
+	// Get identifier of the ImGui list that was the source of the last transfer. ImGui keeps a persistent draw list
+	// for every window, so this allows to track lists between frames.
+	FORCEINLINE UPTRINT GetSourceId() const { return SourceId; }
 
 	// Transfers data from ImGui source list to this object. Leaves source cleared.
 	void TransferDrawData(ImDrawList& Src);
@@ -67,4 +124,74 @@ private:
 	ImVector<ImDrawCmd> ImGuiCommandBuffer;
 	ImVector<ImDrawIdx> ImGuiIndexBuffer;
 	ImVector<ImDrawVert> ImGuiVertexBuffer;
+
+	// Vertex ranges and bounds of vertices addressed by draw commands, calculated during transfer.
+	TArray<Utilities::TRange<int32>> VertexRanges;
+	TArray<FSlateRect> CommandBounds;
+
+	uint64 ContentHash = 0;
+	UPTRINT SourceId = 0;
+};
+
+// Draw data of a whole context converted to Slate format. Consecutive draw commands, also from different draw lists,
+// are merged into batches if they use the same texture and their clipping is equivalent, so each batch can be
+// submitted to Slate as a single element.
+class FImGuiSlateDrawData
+{
+public:
+
+	// Merge draw commands into batches and convert them (old data are replaced, but allocations are reused).
+	// @param DrawLists - Source draw lists
+	// @param VertexPositionOffset - Position offset added to every vertex to transform it to different space
+	// @param WidgetClippingRect - Clipping rectangle of the widget in the target space (clipping rectangles of
+	//     commands are offset to its top-left corner and limited by it)
+	// @param bParallel - Whether to convert commands in parallel (batches are planned sequentially, but after that
+	//     every command is copied to its own part of the batch buffers)
+	// @param bCullTriangles - Whether to remove triangles outside of clipping rectangles of partially clipped
+	//     commands (commands that are completely clipped are always removed)
+	// @returns True, if data were converted or false, if draw lists and parameters didn't change since the last
+	//     update and previously converted batches are reused
+	bool Update(const TArray<FImGuiDrawList>& DrawLists, const FVector2D VertexPositionOffset,
+		const FSlateRect& WidgetClippingRect, bool bParallel, bool bCullTriangles);
+
+	// Merge draw commands into batches and convert them using parameters from the last update. This allows to prepare
+	// batches before they are needed, so they can be reused if the next update has the same parameters.
+	// @param DrawLists - Source draw lists
+	// @param bParallel - Whether to convert commands in parallel
+	// @returns True, if data were converted or false, if there was no previous update or batches are reused
+	bool UpdateWithLastParameters(const TArray<FImGuiDrawList>& DrawLists, bool bParallel);
+
+	// Get combined hash of all draw lists.
+	static uint64 ComputeDrawDataHash(const TArray<FImGuiDrawList>& DrawLists);
+
+	// Get converted batches in drawing order.
+	const TArray<FImGuiSlateDrawCommand>& GetBatches() const { return Batches; }
+
+private:
+
+	// Draw command merged into a batch, with its position in source and batch buffers.
+	struct FSegment
+	{
+		int32 ListNb;
+		Utilities::TRange<int32> VertexRange;
+		int32 StartIndex;
+		int32 NumElements;
+		bool bCulled;
+		int32 BatchNb;
+		int32 BatchVertexOffset;
+		int32 BatchIndexOffset;
+	};
+
+	TArray<FImGuiSlateDrawCommand> Batches;
+	TArray<FSegment> Segments;
+
+	// Indices of culled commands. Those segments have start index in this buffer rather than in their draw lists.
+	TArray<ImDrawIdx> CulledIndices;
+
+	// Source and parameters of the last conversion, used to detect when batches can be reused.
+	uint64 DrawDataHash = 0;
+	FVector2D ConvertedVertexPositionOffset;
+	FSlateRect ConvertedClippingRect;
+	bool bConvertedWithCulling = false;
+	bool bHasConvertedData = false;
 };
@@ -0,0 +1,341 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#include "ImGuiDrawElement.h"
+
+#include "ImGuiPrivatePCH.h"
+
+#if WITH_IMGUI_SHADERS
+
+#include <PipelineStateCache.h>
+#include <RenderingThread.h>
+#include <RenderResource.h>
+#include <RHIStaticStates.h>
+#include <RHIUtilities.h>
+
+
+namespace
+{
+	// Vertex declaration matching ImDrawVert, whatever layout is configured in imconfig.h.
+	class FImGuiVertexDeclaration : public FRenderResource
+	{
+	public:
+
+		FVertexDeclarationRHIRef VertexDeclarationRHI;
+
+		virtual void InitRHI() override
+		{
+			// VET_Color expects BGRA byte order, what matches ImGui colors packed with IMGUI_USE_BGRA_PACKED_COLOR.
+			const EVertexElementType ColorType = (IM_COL32_R_SHIFT == 16) ? VET_Color : VET_UByte4N;
+			const uint16 Stride = sizeof(ImDrawVert);
+
+			FVertexDeclarationElementList Elements;
+			Elements.Add(FVertexElement(0, STRUCT_OFFSET(ImDrawVert, pos), VET_Float2, 0, Stride));
+			Elements.Add(FVertexElement(0, STRUCT_OFFSET(ImDrawVert, uv), VET_Float2, 1, Stride));
+			Elements.Add(FVertexElement(0, STRUCT_OFFSET(ImDrawVert, col), ColorType, 2, Stride));
+			VertexDeclarationRHI = RHICreateVertexDeclaration(Elements);
+		}
+
+		virtual void ReleaseRHI() override
+		{
+			VertexDeclarationRHI.SafeRelease();
+		}
+	};
+
+	TGlobalResource<FImGuiVertexDeclaration> GImGuiVertexDeclaration;
+
+	// Regions get some slack, so lists can grow a little without being moved.
+	FORCEINLINE uint32 GetRegionCapacity(int32 Num)
+	{
+		return static_cast<uint32>(Num + Num / 4 + 16);
+	}
+}
+
+bool FImGuiDrawElement::AssignRegions(const TArray<FImGuiDrawList>& DrawLists, FRenderData& OutRenderData, bool bCompact)
+{
+	OutRenderData.VertexBuffer.Reset();
+	OutRenderData.IndexBuffer.Reset();
+	OutRenderData.Uploads.Reset();
+
+	if (bCompact)
+	{
+		Regions.Reset();
+		NumAllocatedVertices = 0;
+		NumAllocatedIndices = 0;
+
+		// Make sure that buffers can fit all lists. Capacity only grows, so buffers are rarely recreated.
+		uint32 RequiredVertices = 0, RequiredIndices = 0;
+		for (const FImGuiDrawList& DrawList : DrawLists)
+		{
+			RequiredVertices += GetRegionCapacity(DrawList.NumVertices());
+			RequiredIndices += GetRegionCapacity(DrawList.NumIndices());
+		}
+
+		AllocatedVertexCapacity = FMath::Max(AllocatedVertexCapacity, FMath::RoundUpToPowerOfTwo(RequiredVertices));
+		AllocatedIndexCapacity = FMath::Max(AllocatedIndexCapacity, FMath::RoundUpToPowerOfTwo(RequiredIndices));
+	}
+
+	for (const FImGuiDrawList& DrawList : DrawLists)
+	{
+		const uint32 NumVertices = DrawList.NumVertices();
+		const uint32 NumIndices = DrawList.NumIndices();
+
+		FRegion* Region = Regions.Find(DrawList.GetSourceId());
+		if (!Region || Region->VertexCapacity < NumVertices || Region->IndexCapacity < NumIndices)
+		{
+			// Allocate a new region at the end of the buffers. Space of the old one is reclaimed during compaction.
+			const uint32 VertexCapacity = GetRegionCapacity(NumVertices);
+			const uint32 IndexCapacity = GetRegionCapacity(NumIndices);
+
+			if (NumAllocatedVertices + VertexCapacity > AllocatedVertexCapacity
+				|| NumAllocatedIndices + IndexCapacity > AllocatedIndexCapacity)
+			{
+				return false;
+			}
+
+			Region = &Regions.Add(DrawList.GetSourceId(), { NumAllocatedVertices, VertexCapacity, NumAllocatedIndices, IndexCapacity, 0, 0, false });
+			NumAllocatedVertices += VertexCapacity;
+			NumAllocatedIndices += IndexCapacity;
+		}
+
+		// Only lists with changed content need to be uploaded.
+		if (!Region->bHasContent || Region->ContentHash != DrawList.GetContentHash())
+		{
+			OutRenderData.Uploads.Add({ Region->VertexOffset, Region->IndexOffset, OutRenderData.VertexBuffer.Num(),
+				OutRenderData.IndexBuffer.Num(), static_cast<int32>(NumVertices), static_cast<int32>(NumIndices) });
+			DrawList.AppendRawData(OutRenderData.VertexBuffer, OutRenderData.IndexBuffer);
+
+			Region->ContentHash = DrawList.GetContentHash();
+			Region->bHasContent = true;
+		}
+
+		Region->LastUpdate = UpdateCounter;
+	}
+
+	// Forget regions of lists that are not drawn anymore.
+	for (auto It = Regions.CreateIterator(); It; ++It)
+	{
+		if (It.Value().LastUpdate != UpdateCounter)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	OutRenderData.VertexBufferCapacity = AllocatedVertexCapacity;
+	OutRenderData.IndexBufferCapacity = AllocatedIndexCapacity;
+
+	return true;
+}
+
+void FImGuiDrawElement::Update(const TArray<FImGuiDrawList>& DrawLists, const FTextureManager& TextureManager,
+	const FVector2D& VertexPositionOffset, const FSlateRect& ClippingRect)
+{
+	FRenderData* NewRenderData = new FRenderData();
+	NewRenderData->VertexPositionOffset = VertexPositionOffset;
+
+	UpdateCounter++;
+
+	// Try to fit lists in the current regions and if buffers are full, compact them.
+	if (!AssignRegions(DrawLists, *NewRenderData, false))
+	{
+		verify(AssignRegions(DrawLists, *NewRenderData, true));
+	}
+
+	int32 NumCommands = 0;
+	for (const FImGuiDrawList& DrawList : DrawLists)
+	{
+		NumCommands += DrawList.NumCommands();
+	}
+	NewRenderData->Commands.Reserve(NumCommands);
+
+	for (const FImGuiDrawList& DrawList : DrawLists)
+	{
+		// Every list is drawn from its own region. Indices are relative to lists, so we draw them with base vertex.
+		const FRegion& Region = Regions.FindChecked(DrawList.GetSourceId());
+		const int32 BaseVertex = Region.VertexOffset;
+		uint32 StartIndex = Region.IndexOffset;
+
+		for (int CommandNb = 0; CommandNb < DrawList.NumCommands(); CommandNb++)
+		{
+			const FImGuiDrawCommand& DrawCommand = DrawList.GetCommand(CommandNb);
+
+			// Transform clipping rectangle and bounds to render target space.
+			const FSlateRect CommandClippingRect = DrawCommand.ClippingRect.OffsetBy(ClippingRect.GetTopLeft()).IntersectionWith(ClippingRect);
+			const FSlateRect Bounds = DrawCommand.Bounds.OffsetBy(VertexPositionOffset);
+
+			// If geometry is inside of its clipping rectangle, we can use widget rectangle instead. This doesn't change
+			// the output but allows to merge commands that ImGui split only to change clipping.
+			const bool bClipped = Bounds.Left < CommandClippingRect.Left || Bounds.Top < CommandClippingRect.Top
+				|| Bounds.Right > CommandClippingRect.Right || Bounds.Bottom > CommandClippingRect.Bottom;
+			const FSlateRect& EffectiveClippingRect = bClipped ? CommandClippingRect : ClippingRect;
+
+			const FIntRect ScissorRect{ FMath::FloorToInt(EffectiveClippingRect.Left), FMath::FloorToInt(EffectiveClippingRect.Top),
+				FMath::CeilToInt(EffectiveClippingRect.Right), FMath::CeilToInt(EffectiveClippingRect.Bottom) };
+
+			if (DrawCommand.NumElements > 0 && ScissorRect.Width() > 0 && ScissorRect.Height() > 0)
+			{
+				// Get texture resource for this draw command (null index will be also mapped to a valid texture).
+				FTextureResource* Texture = TextureManager.GetTexture(DrawCommand.TextureId)->Resource;
+				const bool bAlphaTexture = TextureManager.IsAlphaTexture(DrawCommand.TextureId);
+				const bool bDistanceFieldTexture = TextureManager.IsDistanceFieldTexture(DrawCommand.TextureId);
+
+				// Extend the last command if this one continues it with the same state.
+				FRenderData::FDrawCommand* LastCommand = NewRenderData->Commands.Num() > 0 ? &NewRenderData->Commands.Last() : nullptr;
+				if (LastCommand && LastCommand->BaseVertex == BaseVertex && LastCommand->Texture == Texture
+					&& LastCommand->ScissorRect == ScissorRect && LastCommand->StartIndex + LastCommand->NumElements == StartIndex)
+				{
+					LastCommand->NumElements += DrawCommand.NumElements;
+				}
+				else
+				{
+					NewRenderData->Commands.Add({ StartIndex, DrawCommand.NumElements, BaseVertex,
+						static_cast<uint32>(DrawList.NumVertices()), ScissorRect, Texture, bAlphaTexture,
+						bDistanceFieldTexture });
+				}
+			}
+
+			StartIndex += DrawCommand.NumElements;
+		}
+	}
+
+	using FSharedDrawElement = TSharedRef<FImGuiDrawElement, ESPMode::ThreadSafe>;
+
+	ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
+		ImGuiDrawElementUpdate,
+		FSharedDrawElement, Element, AsShared(),
+		FRenderData*, NewRenderData, NewRenderData,
+		{
+			Element->SetRenderData_RenderThread(NewRenderData);
+		});
+}
+
+void FImGuiDrawElement::SetRenderData_RenderThread(FRenderData* NewRenderData)
+{
+	check(IsInRenderingThread());
+
+	// Upload data as soon as we get them, because the next snapshot can replace this one before it is drawn.
+	RenderData.Reset(NewRenderData);
+	UploadBuffers();
+}
+
+void FImGuiDrawElement::UploadBuffers()
+{
+	if (RenderData->VertexBufferCapacity == 0 || RenderData->IndexBufferCapacity == 0)
+	{
+		// Nothing was drawn yet.
+		return;
+	}
+
+	// Regions are assigned by the game thread with assumption that buffers have requested capacity. If it changed,
+	// then regions were compacted and all data are uploaded again, so old content can be discarded.
+	if (VertexBufferCapacity != RenderData->VertexBufferCapacity || !VertexBufferRHI.IsValid())
+	{
+		VertexBufferCapacity = RenderData->VertexBufferCapacity;
+		FRHIResourceCreateInfo CreateInfo;
+		VertexBufferRHI = RHICreateVertexBuffer(VertexBufferCapacity * sizeof(ImDrawVert), BUF_Static, CreateInfo);
+	}
+
+	if (IndexBufferCapacity != RenderData->IndexBufferCapacity || !IndexBufferRHI.IsValid())
+	{
+		IndexBufferCapacity = RenderData->IndexBufferCapacity;
+		FRHIResourceCreateInfo CreateInfo;
+		IndexBufferRHI = RHICreateIndexBuffer(sizeof(ImDrawIdx), IndexBufferCapacity * sizeof(ImDrawIdx), BUF_Static, CreateInfo);
+	}
+
+	// Buffers are static, so locking a range doesn't discard content outside of it.
+	for (const FRenderData::FUpload& Upload : RenderData->Uploads)
+	{
+		if (Upload.NumVertices > 0)
+		{
+			const uint32 Size = Upload.NumVertices * sizeof(ImDrawVert);
+			void* VertexData = RHILockVertexBuffer(VertexBufferRHI, Upload.VertexOffset * sizeof(ImDrawVert), Size, RLM_WriteOnly);
+			FMemory::Memcpy(VertexData, RenderData->VertexBuffer.GetData() + Upload.SourceVertex, Size);
+			RHIUnlockVertexBuffer(VertexBufferRHI);
+		}
+
+		if (Upload.NumIndices > 0)
+		{
+			const uint32 Size = Upload.NumIndices * sizeof(ImDrawIdx);
+			void* IndexData = RHILockIndexBuffer(IndexBufferRHI, Upload.IndexOffset * sizeof(ImDrawIdx), Size, RLM_WriteOnly);
+			FMemory::Memcpy(IndexData, RenderData->IndexBuffer.GetData() + Upload.SourceIndex, Size);
+			RHIUnlockIndexBuffer(IndexBufferRHI);
+		}
+	}
+
+	// Uploaded data are not needed anymore.
+	RenderData->VertexBuffer.Empty();
+	RenderData->IndexBuffer.Empty();
+	RenderData->Uploads.Empty();
+}
+
+void FImGuiDrawElement::DrawRenderThread(FRHICommandListImmediate& RHICmdList, const void* InWindowBackBuffer)
+{
+	check(IsInRenderingThread());
+
+	// Slate passes back buffer of the window that is already set as a render target.
+	Draw_RenderThread(RHICmdList, *static_cast<const FTexture2DRHIRef*>(InWindowBackBuffer));
+}
+
+void FImGuiDrawElement::DrawToRenderTarget_RenderThread(FRHICommandListImmediate& RHICmdList, FTextureRenderTargetResource* RenderTarget)
+{
+	check(IsInRenderingThread());
+
+	// Clear to transparent color of the render target, draw and copy result to the texture that is used for sampling.
+	const FTexture2DRHIRef& RenderTargetTexture = RenderTarget->GetRenderTargetTexture();
+	SetRenderTarget(RHICmdList, RenderTargetTexture, FTextureRHIRef(), ESimpleRenderTargetMode::EClearColorExistingDepth);
+	Draw_RenderThread(RHICmdList, RenderTargetTexture);
+	RHICmdList.CopyToResolveTarget(RenderTargetTexture, RenderTarget->TextureRHI, true, FResolveParams());
+}
+
+void FImGuiDrawElement::Draw_RenderThread(FRHICommandListImmediate& RHICmdList, const FTexture2DRHIRef& RenderTarget)
+{
+	if (!RenderData.IsValid() || RenderData->Commands.Num() == 0)
+	{
+		return;
+	}
+
+	const int32 Width = RenderTarget->GetSizeX();
+	const int32 Height = RenderTarget->GetSizeY();
+
+	RHICmdList.SetViewport(0, 0, 0.f, Width, Height, 1.f);
+
+	TShaderMapRef<FImGuiVS> VertexShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+	TShaderMapRef<FImGuiPS> PixelShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+
+	FGraphicsPipelineStateInitializer GraphicsPSOInit;
+	RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+	GraphicsPSOInit.BlendState = TStaticBlendState<CW_RGBA, BO_Add, BF_SourceAlpha, BF_InverseSourceAlpha, BO_Add, BF_One, BF_InverseSourceAlpha>::GetRHI();
+	GraphicsPSOInit.RasterizerState = TStaticRasterizerState<FM_Solid, CM_None>::GetRHI();
+	GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
+	GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GImGuiVertexDeclaration.VertexDeclarationRHI;
+	GraphicsPSOInit.BoundShaderState.VertexShaderRHI = GETSAFERHISHADER_VERTEX(*VertexShader);
+	GraphicsPSOInit.BoundShaderState.PixelShaderRHI = GETSAFERHISHADER_PIXEL(*PixelShader);
+	GraphicsPSOInit.PrimitiveType = PT_TriangleList;
+	SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit);
+
+	// Transform from render target pixels to clip space (with inverted Y axis).
+	const FVector2D& Offset = RenderData->VertexPositionOffset;
+	VertexShader->SetParameters(RHICmdList, FVector2D{ 2.f / Width, -2.f / Height },
+		FVector2D{ 2.f * Offset.X / Width - 1.f, 1.f - 2.f * Offset.Y / Height });
+
+	RHICmdList.SetStreamSource(0, VertexBufferRHI, 0);
+
+	const FIntRect RenderTargetRect{ 0, 0, Width, Height };
+	for (const FRenderData::FDrawCommand& Command : RenderData->Commands)
+	{
+		FIntRect ScissorRect = Command.ScissorRect;
+		ScissorRect.Clip(RenderTargetRect);
+		if (ScissorRect.Width() <= 0 || ScissorRect.Height() <= 0 || !Command.Texture)
+		{
+			continue;
+		}
+
+		RHICmdList.SetScissorRect(true, ScissorRect.Min.X, ScissorRect.Min.Y, ScissorRect.Max.X, ScissorRect.Max.Y);
+		PixelShader->SetTexture(RHICmdList, Command.Texture->TextureRHI, Command.bAlphaTexture, Command.bDistanceFieldTexture);
+		RHICmdList.DrawIndexedPrimitive(IndexBufferRHI, PT_TriangleList, Command.BaseVertex, 0, Command.NumVertices,
+			Command.StartIndex, Command.NumElements / 3, 1);
+	}
+
+	RHICmdList.SetScissorRect(false, 0, 0, 0, 0);
+}
+
+#endif // WITH_IMGUI_SHADERS
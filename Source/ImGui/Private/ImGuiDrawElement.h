@@ -0,0 +1,127 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#pragma once
+
+#include "ImGuiDrawData.h"
+#include "ImGuiShaders.h"
+#include "TextureManager.h"
+
+#include <RHI.h>
+#include <Rendering/RenderingCommon.h>
+#include <TextureResource.h>
+
+
+#if WITH_IMGUI_SHADERS
+
+// Custom Slate element that renders ImGui draw data on the render thread using its own vertex and index buffers,
+// scissor rectangles and texture bindings. This bypasses Slate batching and because the render thread gets data in
+// ImGui format, vertices and indices don't need to be converted.
+//
+// Buffers are persistent and every draw list has its own region in them, so only lists with content that changed
+// since the last update need to be passed to the render thread and uploaded. Regions are assigned on the game thread
+// and when buffers are full, they are compacted and all data are uploaded again.
+class FImGuiDrawElement : public ICustomSlateElement, public TSharedFromThis<FImGuiDrawElement, ESPMode::ThreadSafe>
+{
+public:
+
+	// Snapshot of draw data prepared on the game thread and consumed by the render thread.
+	struct FRenderData
+	{
+		struct FDrawCommand
+		{
+			uint32 StartIndex;
+			uint32 NumElements;
+			int32 BaseVertex;
+			uint32 NumVertices;
+			FIntRect ScissorRect;
+			FTextureResource* Texture;
+			bool bAlphaTexture;
+			bool bDistanceFieldTexture;
+		};
+
+		// Data to copy from this snapshot to a region in the persistent buffers.
+		struct FUpload
+		{
+			uint32 VertexOffset;
+			uint32 IndexOffset;
+			int32 SourceVertex;
+			int32 SourceIndex;
+			int32 NumVertices;
+			int32 NumIndices;
+		};
+
+		// Data of draw lists that need to be uploaded.
+		TArray<ImDrawVert> VertexBuffer;
+		TArray<ImDrawIdx> IndexBuffer;
+		TArray<FUpload> Uploads;
+
+		TArray<FDrawCommand> Commands;
+		FVector2D VertexPositionOffset;
+
+		// Required capacity of the persistent buffers (in elements). If that changes, buffers are recreated.
+		uint32 VertexBufferCapacity = 0;
+		uint32 IndexBufferCapacity = 0;
+	};
+
+	// Take a snapshot of draw lists and pass it to the render thread. Should be called on the game thread, before this
+	// element is added to window draw elements.
+	// @param DrawLists - Draw lists to render
+	// @param TextureManager - Texture manager to resolve texture indices
+	// @param VertexPositionOffset - Position offset transforming vertices to render target space
+	// @param ClippingRect - Clipping rectangle in render target space
+	void Update(const TArray<FImGuiDrawList>& DrawLists, const FTextureManager& TextureManager,
+		const FVector2D& VertexPositionOffset, const FSlateRect& ClippingRect);
+
+	// Replace render data with a new snapshot and upload its data. Should be only called on the render thread.
+	void SetRenderData_RenderThread(FRenderData* NewRenderData);
+
+	// Clear render target and draw the last snapshot to it. Should be only called on the render thread.
+	// @param RHICmdList - Command list
+	// @param RenderTarget - Render target resource (vertex positions need to be in its space)
+	void DrawToRenderTarget_RenderThread(FRHICommandListImmediate& RHICmdList, FTextureRenderTargetResource* RenderTarget);
+
+private:
+
+	// Region of the persistent buffers assigned to a draw list.
+	struct FRegion
+	{
+		uint32 VertexOffset;
+		uint32 VertexCapacity;
+		uint32 IndexOffset;
+		uint32 IndexCapacity;
+		uint64 ContentHash;
+		uint32 LastUpdate;
+		bool bHasContent;
+	};
+
+	virtual void DrawRenderThread(FRHICommandListImmediate& RHICmdList, const void* InWindowBackBuffer) override;
+
+	// Draw the last snapshot to the render target that is currently set.
+	void Draw_RenderThread(FRHICommandListImmediate& RHICmdList, const FTexture2DRHIRef& RenderTarget);
+
+	// Assign buffer regions to draw lists and add data of changed lists to render data.
+	// @param bCompact - Whether to discard all regions and assign them from the start of the buffers
+	// @returns True, if all lists got a region or false, if buffers are full and need to be compacted
+	bool AssignRegions(const TArray<FImGuiDrawList>& DrawLists, FRenderData& OutRenderData, bool bCompact);
+
+	// Upload snapshot data to RHI buffers, recreating them if their capacity changed.
+	void UploadBuffers();
+
+	// Game thread state of the buffer regions, updated before every snapshot is passed to the render thread.
+	TMap<UPTRINT, FRegion> Regions;
+	uint32 NumAllocatedVertices = 0;
+	uint32 NumAllocatedIndices = 0;
+	uint32 AllocatedVertexCapacity = 0;
+	uint32 AllocatedIndexCapacity = 0;
+	uint32 UpdateCounter = 0;
+
+	// Render thread state.
+	TUniquePtr<FRenderData> RenderData;
+
+	FVertexBufferRHIRef VertexBufferRHI;
+	FIndexBufferRHIRef IndexBufferRHI;
+	uint32 VertexBufferCapacity = 0;
+	uint32 IndexBufferCapacity = 0;
+};
+
+#endif // WITH_IMGUI_SHADERS
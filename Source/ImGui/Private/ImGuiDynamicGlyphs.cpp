@@ -0,0 +1,373 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#include "ImGuiDynamicGlyphs.h"
+
+#include "ImGuiPrivatePCH.h"
+
+
+DEFINE_LOG_CATEGORY_STATIC(LogImGuiDynamicGlyphs, Warning, All);
+
+namespace CVars
+{
+	TAutoConsoleVariable<int> DynamicGlyphsMinGlyphs(TEXT("ImGui.DynamicGlyphs.MinGlyphs"), 1024,
+		TEXT("Minimal number of glyphs in ranges of a font config, above which glyphs are rasterized on demand rather than\n")
+		TEXT("when atlas is built. Applied when atlas is built.\n")
+		TEXT("0: disabled, all glyphs are built with atlas\n")
+		TEXT("N: font configs with at least N glyphs are built only with basic Latin glyphs (default: 1024)"),
+		ECVF_Default);
+
+	TAutoConsoleVariable<int> DynamicGlyphsPageHeight(TEXT("ImGui.DynamicGlyphs.PageHeight"), 512,
+		TEXT("Height in pixels of the atlas page for glyphs rasterized on demand and fonts added after atlas is built.\n")
+		TEXT("Applied when atlas is built."),
+		ECVF_Default);
+}
+
+namespace
+{
+	// Glyphs of dynamic configs that are built with atlas (basic Latin, including fallback character).
+	const ImWchar BuiltRanges[] = { 0x0020, 0x007E, 0 };
+
+	// Configs merged into other fonts don't need built glyphs.
+	const ImWchar NoRanges[] = { 0 };
+
+	// Glyph cache that handles missing glyphs. There is only one shared atlas, so we don't need to map fonts to caches.
+	std::atomic<FImGuiDynamicGlyphs*> ActiveDynamicGlyphs{ nullptr };
+
+	int32 CountGlyphs(const ImWchar* Ranges)
+	{
+		int32 Count = 0;
+		for (; Ranges[0] && Ranges[1]; Ranges += 2)
+		{
+			Count += Ranges[1] - Ranges[0] + 1;
+		}
+		return Count;
+	}
+
+	bool IsInRanges(const ImWchar* Ranges, int32 Codepoint)
+	{
+		for (; Ranges[0] && Ranges[1]; Ranges += 2)
+		{
+			if (Codepoint >= Ranges[0] && Codepoint <= Ranges[1])
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+void ImGuiOnGlyphMiss(const ImFont* Font, unsigned short Codepoint)
+{
+#if IMGUI_USE_FONT_ACCESS_HOOKS
+	// Glyphs can be looked up outside of text functions, so we need to make sure that atlas is not rebuilt meanwhile.
+	ImGuiBeginFontAccess();
+#endif
+
+	if (FImGuiDynamicGlyphs* DynamicGlyphs = ActiveDynamicGlyphs.load(std::memory_order_acquire))
+	{
+		DynamicGlyphs->Request(Font, Codepoint);
+	}
+
+#if IMGUI_USE_FONT_ACCESS_HOOKS
+	ImGuiEndFontAccess();
+#endif
+}
+
+FImGuiDynamicGlyphs::~FImGuiDynamicGlyphs()
+{
+	Reset();
+}
+
+void FImGuiDynamicGlyphs::PrepareInputs(ImFontAtlas& Atlas)
+{
+	Reset();
+
+	const int32 MinGlyphs = CVars::DynamicGlyphsMinGlyphs.GetValueOnGameThread();
+	if (MinGlyphs <= 0)
+	{
+		// Restore ranges of configs that were dynamic, so they are built with atlas.
+		for (const FDynamicConfig& DynamicConfig : DynamicConfigs)
+		{
+			Atlas.ConfigData[DynamicConfig.ConfigIndex].GlyphRanges = DynamicConfig.Ranges;
+		}
+		DynamicConfigs.Empty();
+		return;
+	}
+
+	// Configs are selected once, because their ranges are replaced (this keeps them dynamic if atlas is rebuilt).
+	for (int32 ConfigIndex = 0; ConfigIndex < Atlas.ConfigData.Size; ConfigIndex++)
+	{
+		ImFontConfig& Config = Atlas.ConfigData[ConfigIndex];
+		const bool bIsDynamic = DynamicConfigs.ContainsByPredicate([ConfigIndex](const FDynamicConfig& DynamicConfig)
+		{
+			return DynamicConfig.ConfigIndex == ConfigIndex;
+		});
+
+		if (!bIsDynamic && Config.GlyphRanges && CountGlyphs(Config.GlyphRanges) >= MinGlyphs)
+		{
+			DynamicConfigs.Add({ ConfigIndex, Config.GlyphRanges });
+			Config.GlyphRanges = Config.MergeMode ? NoRanges : BuiltRanges;
+		}
+	}
+}
+
+void FImGuiDynamicGlyphs::Initialize(ImFontAtlas& Atlas, ImGuiMouseCursorData (&InOutMouseCursorData)[ImGuiMouseCursor_Count_])
+{
+	if (!Atlas.TexPixelsAlpha8)
+	{
+		return;
+	}
+
+	// Add spare page at the bottom of the atlas, keeping texture height a power of two.
+	const int32 BuiltHeight = Atlas.TexHeight;
+	const int32 PageHeight = FMath::Max(CVars::DynamicGlyphsPageHeight.GetValueOnGameThread(), 1);
+	const int32 NewHeight = FMath::RoundUpToPowerOfTwo(BuiltHeight + PageHeight);
+
+	unsigned char* Pixels = static_cast<unsigned char*>(ImGui::MemAlloc(Atlas.TexWidth * NewHeight));
+	FMemory::Memcpy(Pixels, Atlas.TexPixelsAlpha8, Atlas.TexWidth * BuiltHeight);
+	FMemory::Memzero(Pixels + Atlas.TexWidth * BuiltHeight, Atlas.TexWidth * (NewHeight - BuiltHeight));
+	Atlas.ClearTexData();
+	Atlas.TexPixelsAlpha8 = Pixels;
+	Atlas.TexHeight = NewHeight;
+
+	PageOffsetY = BuiltHeight;
+	Page = MakeUnique<ImGuiImplementation::FGlyphPage>(Atlas.TexWidth, NewHeight - BuiltHeight, Atlas.TexGlyphPadding);
+
+	// Texture coordinates are normalized, so they need to be rescaled to the new height.
+	const float ScaleV = static_cast<float>(BuiltHeight) / NewHeight;
+
+	Atlas.TexUvWhitePixel.y *= ScaleV;
+
+	for (ImGuiMouseCursorData& CursorData : InOutMouseCursorData)
+	{
+		for (int32 Index = 0; Index < 2; Index++)
+		{
+			CursorData.TexUvMin[Index].y *= ScaleV;
+			CursorData.TexUvMax[Index].y *= ScaleV;
+		}
+	}
+
+	for (ImFont* Font : Atlas.Fonts)
+	{
+		for (ImFontGlyph& Glyph : Font->Glyphs)
+		{
+			Glyph.V0 *= ScaleV;
+			Glyph.V1 *= ScaleV;
+		}
+	}
+
+	// Group dynamic configs by fonts.
+	for (int32 Index = 0; Index < DynamicConfigs.Num(); Index++)
+	{
+		ImFont* Font = Atlas.ConfigData[DynamicConfigs[Index].ConfigIndex].DstFont;
+
+		FDynamicFont* DynamicFont = DynamicFonts.FindByPredicate([Font](const FDynamicFont& Entry) { return Entry.Font == Font; });
+		if (!DynamicFont)
+		{
+			DynamicFont = &DynamicFonts[DynamicFonts.AddDefaulted()];
+			DynamicFont->Font = Font;
+		}
+
+		DynamicFont->Configs.Add(Index);
+	}
+
+	// Reserve glyphs and index for all codepoints that can be added, so fonts are never reallocated when other threads
+	// use them.
+	for (FDynamicFont& DynamicFont : DynamicFonts)
+	{
+		ImFont& Font = *DynamicFont.Font;
+
+		int32 MaxGlyphs = 0;
+		int32 MaxCodepoint = 0;
+		for (int32 ConfigIndex : DynamicFont.Configs)
+		{
+			for (const ImWchar* Range = DynamicConfigs[ConfigIndex].Ranges; Range[0] && Range[1]; Range += 2)
+			{
+				MaxGlyphs += Range[1] - Range[0] + 1;
+				MaxCodepoint = FMath::Max<int32>(MaxCodepoint, Range[1]);
+			}
+		}
+
+		// ImGui indexes glyphs with 16-bit values, with the last one reserved.
+		Font.Glyphs.reserve(FMath::Min(Font.Glyphs.Size + MaxGlyphs, 0xFFFF));
+
+		// Reserving glyphs moves them, so lookup table needs to be rebuilt to update the fallback glyph.
+		Font.BuildLookupTable();
+
+		const int32 OldIndexSize = Font.IndexLookup.Size;
+		Font.GrowIndex(MaxCodepoint + 1);
+		for (int32 Index = OldIndexSize; Index < Font.IndexAdvanceX.Size; Index++)
+		{
+			Font.IndexAdvanceX[Index] = Font.FallbackAdvanceX;
+		}
+
+		DynamicFont.NumCodepoints = MaxCodepoint + 1;
+		DynamicFont.RequestedBits = MakeUnique<std::atomic<uint32>[]>((DynamicFont.NumCodepoints + 31) / 32);
+	}
+
+	ActiveDynamicGlyphs.store(this, std::memory_order_release);
+}
+
+bool FImGuiDynamicGlyphs::AddFont(ImFontAtlas& Atlas, int32 ConfigIndex, FIntRect& OutDirtyRect)
+{
+	check(IsInGameThread());
+
+	if (!Page.IsValid())
+	{
+		return false;
+	}
+
+	ImFontConfig& Config = Atlas.ConfigData[ConfigIndex];
+
+	const int32 MinGlyphs = CVars::DynamicGlyphsMinGlyphs.GetValueOnGameThread();
+	if (MinGlyphs > 0 && CountGlyphs(Config.GlyphRanges) >= MinGlyphs)
+	{
+		return false;
+	}
+
+	// Fonts with glyphs rasterized on demand have reserved space that cannot be shared with other configs.
+	if (DynamicFonts.ContainsByPredicate([&Config](const FDynamicFont& DynamicFont) { return DynamicFont.Font == Config.DstFont; }))
+	{
+		return false;
+	}
+
+	FIntRect DirtyRect{ 0, 0, 0, 0 };
+	const bool bAdded = Page->AddFont(Atlas, Config, PageOffsetY, DirtyRect);
+	OutDirtyRect = DirtyRect.Area() > 0 ? DirtyRect + FIntPoint{ 0, PageOffsetY } : FIntRect{ 0, 0, 0, 0 };
+	return bAdded;
+}
+
+bool FImGuiDynamicGlyphs::Update(ImFontAtlas& Atlas, FIntRect& OutDirtyRect)
+{
+	check(IsInGameThread());
+
+	if (!Page.IsValid() || Requests.IsEmpty())
+	{
+		return false;
+	}
+
+	// Group requests by fonts.
+	TArray<TArray<int32>> Pending;
+	Pending.SetNum(DynamicFonts.Num());
+
+	FRequest Request;
+	while (Requests.Dequeue(Request))
+	{
+		Pending[Request.FontIndex].Add(Request.Codepoint);
+	}
+
+	FIntRect DirtyRect{ 0, 0, 0, 0 };
+	bool bPageFull = false;
+
+	for (int32 FontIndex = 0; FontIndex < DynamicFonts.Num(); FontIndex++)
+	{
+		TArray<int32>& Codepoints = Pending[FontIndex];
+		TArray<int32> NotPacked;
+
+		// Try configs in order, passing glyphs not available in one config to the next one.
+		for (int32 ConfigIndex : DynamicFonts[FontIndex].Configs)
+		{
+			if (Codepoints.Num() == 0)
+			{
+				break;
+			}
+
+			const FDynamicConfig& DynamicConfig = DynamicConfigs[ConfigIndex];
+
+			TArray<int32> InRanges;
+			TArray<int32> Remaining;
+			for (int32 Codepoint : Codepoints)
+			{
+				(IsInRanges(DynamicConfig.Ranges, Codepoint) ? InRanges : Remaining).Add(Codepoint);
+			}
+
+			if (InRanges.Num() > 0)
+			{
+				Page->AddGlyphs(Atlas, Atlas.ConfigData[DynamicConfig.ConfigIndex], InRanges, PageOffsetY, Remaining,
+					NotPacked, DirtyRect);
+			}
+
+			Codepoints = MoveTemp(Remaining);
+		}
+
+		// Glyphs that were not added are drawn with fallback glyph. Their requests stay set, so they are not retried
+		// every frame: codepoints not available in any config cannot be added until fonts change and glyphs that didn't
+		// fit can be requested again after atlas is rebuilt, which recreates the page and request bits.
+		bPageFull |= NotPacked.Num() > 0;
+	}
+
+	if (bPageFull && !bPageFullReported)
+	{
+		UE_LOG(LogImGuiDynamicGlyphs, Warning, TEXT("ImGui font atlas page for glyphs rasterized on demand is full. Missing glyphs will be ")
+			TEXT("drawn with fallback glyph. Page size can be increased with ImGui.DynamicGlyphs.PageHeight."));
+		bPageFullReported = true;
+	}
+
+	if (DirtyRect.Area() > 0)
+	{
+		OutDirtyRect = DirtyRect + FIntPoint{ 0, PageOffsetY };
+		return true;
+	}
+
+	return false;
+}
+
+void FImGuiDynamicGlyphs::CopyPageToAtlas(ImFontAtlas& Atlas) const
+{
+	if (Page.IsValid() && Atlas.TexPixelsAlpha8)
+	{
+		check(Atlas.TexWidth == Page->GetWidth() && Atlas.TexHeight == PageOffsetY + Page->GetHeight());
+		FMemory::Memcpy(Atlas.TexPixelsAlpha8 + Atlas.TexWidth * PageOffsetY, Page->GetPixels(),
+			Page->GetWidth() * Page->GetHeight());
+	}
+}
+
+void FImGuiDynamicGlyphs::CopyPageRect(const FIntRect& Rect, uint8* Destination) const
+{
+	check(Page.IsValid() && Rect.Min.X >= 0 && Rect.Max.X <= Page->GetWidth()
+		&& Rect.Min.Y >= PageOffsetY && Rect.Max.Y <= PageOffsetY + Page->GetHeight());
+
+	const int32 RowSize = Rect.Width();
+	for (int32 Y = Rect.Min.Y; Y < Rect.Max.Y; Y++)
+	{
+		FMemory::Memcpy(Destination, Page->GetPixels() + (Y - PageOffsetY) * Page->GetWidth() + Rect.Min.X, RowSize);
+		Destination += RowSize;
+	}
+}
+
+void FImGuiDynamicGlyphs::Request(const ImFont* Font, ImWchar Codepoint)
+{
+	for (int32 FontIndex = 0; FontIndex < DynamicFonts.Num(); FontIndex++)
+	{
+		const FDynamicFont& DynamicFont = DynamicFonts[FontIndex];
+		if (DynamicFont.Font == Font)
+		{
+			if (Codepoint < DynamicFont.NumCodepoints)
+			{
+				// Only the first request is queued, so repeated misses are cheap.
+				const uint32 Bit = 1u << (Codepoint % 32);
+				std::atomic<uint32>& Bits = DynamicFont.RequestedBits[Codepoint / 32];
+				if ((Bits.load(std::memory_order_relaxed) & Bit) == 0 && (Bits.fetch_or(Bit) & Bit) == 0)
+				{
+					Requests.Enqueue({ FontIndex, Codepoint });
+				}
+			}
+			return;
+		}
+	}
+}
+
+void FImGuiDynamicGlyphs::Reset()
+{
+	// Glyphs are only reset when atlas is (re)built. The first build happens before any context uses the atlas and
+	// rebuilds lock fonts against other threads (see FImGuiSharedFontAtlas), so no other thread should be in the middle
+	// of a request.
+	FImGuiDynamicGlyphs* This = this;
+	ActiveDynamicGlyphs.compare_exchange_strong(This, nullptr);
+
+	DynamicFonts.Empty();
+	Requests.Empty();
+	Page.Reset();
+	PageOffsetY = 0;
+	bPageFullReported = false;
+}
@@ -0,0 +1,121 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#pragma once
+
+#include "ImGuiImplementation.h"
+
+#include <Containers/Queue.h>
+
+#include <imgui.h>
+#include <imgui_internal.h>
+
+#include <atomic>
+
+
+// Cache of glyphs rasterized on demand. Font configs with large glyph ranges (like CJK) are built only with basic Latin
+// glyphs and the remaining glyphs are rasterized when ImGui tries to use them for the first time.
+//
+// Missing glyphs are requested by ImFont::FindGlyph and text measuring functions (through a hook that can be called
+// from any thread) and processed on the game thread. They are packed into a spare page added at the bottom of the atlas
+// and inserted into fonts without reallocations, so other threads can use fonts at the same time. Text with new glyphs
+// is drawn with fallback glyphs until the next frame. Glyphs that cannot be added stay on fallback glyphs until atlas
+// is rebuilt.
+//
+// The page is always added and it is used as free space for fonts added after atlas is built, so they can be added
+// without rebuilding it.
+class FImGuiDynamicGlyphs
+{
+public:
+
+	FImGuiDynamicGlyphs() = default;
+	~FImGuiDynamicGlyphs();
+
+	FImGuiDynamicGlyphs(const FImGuiDynamicGlyphs&) = delete;
+	FImGuiDynamicGlyphs& operator=(const FImGuiDynamicGlyphs&) = delete;
+
+	FImGuiDynamicGlyphs(FImGuiDynamicGlyphs&&) = delete;
+	FImGuiDynamicGlyphs& operator=(FImGuiDynamicGlyphs&&) = delete;
+
+	// Select font configs with glyphs rasterized on demand and limit their ranges to glyphs that are built with atlas.
+	// Needs to be called before atlas is built. Every call resets glyphs that were added on demand.
+	// @param Atlas - Atlas that is going to be built
+	void PrepareInputs(ImFontAtlas& Atlas);
+
+	// Add a spare page to the built atlas and prepare fonts for glyphs added on demand. Page is added also without
+	// font configs with glyphs rasterized on demand, so it can be used by fonts added later. Atlas texture becomes
+	// taller, so texture coordinates of glyphs and mouse cursors are rescaled.
+	// @param Atlas - Built atlas
+	// @param InOutMouseCursorData - Mouse cursor data generated during build
+	void Initialize(ImFontAtlas& Atlas, ImGuiMouseCursorData (&InOutMouseCursorData)[ImGuiMouseCursor_Count_]);
+
+	// Add a font config that was added to the initialized atlas, rasterizing all its glyphs into the spare page. Fails
+	// if there is no page or not enough space in it, or if config should have glyphs rasterized on demand (those need
+	// to be prepared when atlas is built). Should be called on the game thread, when fonts are not used.
+	// @param Atlas - Initialized atlas
+	// @param ConfigIndex - Index of the added config in atlas
+	// @param OutDirtyRect - Rectangle in atlas pixels that was changed
+	// @returns True, if font was added. Otherwise atlas needs to be rebuilt (font might be partially set up).
+	bool AddFont(ImFontAtlas& Atlas, int32 ConfigIndex, FIntRect& OutDirtyRect);
+
+	// Rasterize requested glyphs. Needs to be called on the game thread.
+	// @param Atlas - Initialized atlas
+	// @param OutDirtyRect - Rectangle in atlas pixels that was changed
+	// @returns True, if atlas pixels were changed.
+	bool Update(ImFontAtlas& Atlas, FIntRect& OutDirtyRect);
+
+	// Whether atlas has a spare page for glyphs added on demand.
+	bool HasPage() const { return Page.IsValid(); }
+
+	// Copy pixels from the spare page to atlas pixels.
+	// @param Atlas - Initialized atlas with alpha pixels
+	void CopyPageToAtlas(ImFontAtlas& Atlas) const;
+
+	// Copy pixels from a rectangle in the spare page.
+	// @param Rect - Rectangle in atlas pixels (needs to be inside of the spare page)
+	// @param Destination - Destination buffer with one byte per pixel and rows as wide as the rectangle
+	void CopyPageRect(const FIntRect& Rect, uint8* Destination) const;
+
+	// Request a glyph missing in a font. Can be called from any thread.
+	// @param Font - Font without glyph
+	// @param Codepoint - Codepoint of a missing glyph
+	void Request(const ImFont* Font, ImWchar Codepoint);
+
+private:
+
+	struct FDynamicConfig
+	{
+		int32 ConfigIndex;
+
+		// Original ranges of the config (ImGui requires them to persist as long as the font).
+		const ImWchar* Ranges;
+	};
+
+	struct FDynamicFont
+	{
+		ImFont* Font = nullptr;
+
+		// Indices of configs (in DynamicConfigs) providing glyphs for this font, in the order of atlas configs.
+		TArray<int32> Configs;
+
+		// Bit per codepoint, set when glyph is requested (cleared only when atlas is rebuilt).
+		TUniquePtr<std::atomic<uint32>[]> RequestedBits;
+		int32 NumCodepoints = 0;
+	};
+
+	struct FRequest
+	{
+		int32 FontIndex;
+		ImWchar Codepoint;
+	};
+
+	void Reset();
+
+	TArray<FDynamicConfig> DynamicConfigs;
+	TArray<FDynamicFont> DynamicFonts;
+
+	TQueue<FRequest, EQueueMode::Mpsc> Requests;
+
+	TUniquePtr<ImGuiImplementation::FGlyphPage> Page;
+	int32 PageOffsetY = 0;
+	bool bPageFullReported = false;
+};
@@ -0,0 +1,354 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#include "ImGuiFontAtlasCache.h"
+
+#include "ImGuiPrivatePCH.h"
+
+#include <Misc/Crc.h>
+#include <Misc/FileHelper.h>
+#include <Runtime/Launch/Resources/Version.h>
+
+#include <type_traits>
+
+
+namespace CVars
+{
+	TAutoConsoleVariable<int> FontAtlasCache(TEXT("ImGui.FontAtlasCache"), 1,
+		TEXT("Whether built font atlas should be cached on disk, so it can be loaded without rasterizing glyphs.\n")
+		TEXT("0: disabled, atlas is built every time\n")
+		TEXT("1: enabled, atlas is loaded from Saved/ImGui if its inputs didn't change (default)"),
+		ECVF_Default);
+}
+
+namespace
+{
+	// Identifies cache files. Version needs to be incremented whenever layout of cached data changes.
+	constexpr uint32 CacheMagic = 0x43464D49; // "IMFC"
+	constexpr uint32 CacheVersion = 1;
+
+	// Upper limit for texture dimensions, which is used to validate cached data (ImGui packs glyphs in textures with
+	// height up to 32K).
+	constexpr int32 MaxTextureSize = 32 * 1024;
+
+	FString GetCacheFile()
+	{
+#if (ENGINE_MAJOR_VERSION > 4 || (ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 18))
+		const FString SavedDir = FPaths::ProjectSavedDir();
+#else
+		const FString SavedDir = FPaths::GameSavedDir();
+#endif
+		return FPaths::Combine(*SavedDir, TEXT("ImGui"), TEXT("FontAtlas.cache"));
+	}
+
+	int32 GetFontIndex(const ImFontAtlas& Atlas, const ImFont* Font)
+	{
+		for (int32 Index = 0; Index < Atlas.Fonts.Size; Index++)
+		{
+			if (Atlas.Fonts[Index] == Font)
+			{
+				return Index;
+			}
+		}
+		return INDEX_NONE;
+	}
+
+	// Hash of all inputs that affect atlas build.
+	uint32 ComputeKey(const ImFontAtlas& Atlas)
+	{
+		uint32 Key = FCrc::MemCrc32(IMGUI_VERSION, sizeof(IMGUI_VERSION));
+
+		auto HashBytes = [&Key](const void* Data, int32 Size)
+		{
+			Key = FCrc::MemCrc32(Data, Size, Key);
+		};
+
+		auto Hash = [&HashBytes](const auto& Value)
+		{
+			HashBytes(&Value, sizeof(Value));
+		};
+
+		Hash(Atlas.TexDesiredWidth);
+		Hash(Atlas.TexGlyphPadding);
+
+		const int32 DistanceFieldSpread = IMGUI_SDF_FONT_SPREAD;
+		Hash(DistanceFieldSpread);
+
+		Hash(Atlas.Fonts.Size);
+		Hash(Atlas.ConfigData.Size);
+		for (const ImFontConfig& Config : Atlas.ConfigData)
+		{
+			HashBytes(Config.FontData, Config.FontDataSize);
+			Hash(Config.FontNo);
+			Hash(Config.SizePixels);
+			Hash(Config.OversampleH);
+			Hash(Config.OversampleV);
+			Hash(Config.PixelSnapH);
+			Hash(Config.GlyphExtraSpacing);
+			Hash(Config.GlyphOffset);
+			Hash(Config.MergeMode);
+			Hash(Config.RasterizerFlags);
+			Hash(Config.RasterizerMultiply);
+			Hash(GetFontIndex(Atlas, Config.DstFont));
+
+			const ImWchar* Range = Config.GlyphRanges;
+			while (Range[0] && Range[1])
+			{
+				Range += 2;
+			}
+			HashBytes(Config.GlyphRanges, static_cast<int32>(Range - Config.GlyphRanges) * sizeof(ImWchar));
+		}
+
+		Hash(Atlas.CustomRects.Size);
+		for (const ImFontAtlas::CustomRect& Rect : Atlas.CustomRects)
+		{
+			Hash(Rect.ID);
+			Hash(Rect.Width);
+			Hash(Rect.Height);
+			Hash(Rect.GlyphAdvanceX);
+			Hash(Rect.GlyphOffset);
+			Hash(GetFontIndex(Atlas, Rect.Font));
+		}
+
+		return Key;
+	}
+
+	// Cached data are only used on the machine that generated them, so trivially copyable types are stored as they are
+	// in memory.
+	class FCacheWriter
+	{
+	public:
+
+		template<typename T>
+		void Write(const T& Value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written.");
+			WriteBytes(&Value, sizeof(T));
+		}
+
+		void WriteBytes(const void* Source, int32 Size)
+		{
+			const int32 Offset = Data.AddUninitialized(Size);
+			FMemory::Memcpy(Data.GetData() + Offset, Source, Size);
+		}
+
+		const TArray<uint8>& GetData() const { return Data; }
+
+	private:
+
+		TArray<uint8> Data;
+	};
+
+	class FCacheReader
+	{
+	public:
+
+		FCacheReader(const TArray<uint8>& InData)
+			: Data(InData)
+		{
+		}
+
+		template<typename T>
+		bool Read(T& Value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be read.");
+			return ReadBytes(&Value, sizeof(T));
+		}
+
+		bool ReadBytes(void* Destination, int32 Size)
+		{
+			if (Size < 0 || Size > Data.Num() - Offset)
+			{
+				return false;
+			}
+
+			FMemory::Memcpy(Destination, Data.GetData() + Offset, Size);
+			Offset += Size;
+			return true;
+		}
+
+		bool IsAtEnd() const { return Offset == Data.Num(); }
+
+	private:
+
+		const TArray<uint8>& Data;
+		int32 Offset = 0;
+	};
+
+	struct FRectPosition
+	{
+		uint16 X;
+		uint16 Y;
+	};
+
+	struct FCachedFont
+	{
+		float Ascent = 0.f;
+		float Descent = 0.f;
+		int32 MetricsTotalSurface = 0;
+		TArray<ImFontGlyph> Glyphs;
+	};
+}
+
+namespace ImGuiFontAtlasCache
+{
+	void PrepareInputs(ImFontAtlas& Atlas)
+	{
+		if (Atlas.ConfigData.empty())
+		{
+			Atlas.AddFontDefault();
+		}
+
+		for (ImFontConfig& Config : Atlas.ConfigData)
+		{
+			if (!Config.GlyphRanges)
+			{
+				Config.GlyphRanges = Atlas.GetGlyphRangesDefault();
+			}
+		}
+
+		ImFontAtlasBuildRegisterDefaultCustomRects(&Atlas);
+	}
+
+	bool Load(ImFontAtlas& Atlas, ImGuiMouseCursorData (&OutMouseCursorData)[ImGuiMouseCursor_Count_])
+	{
+		if (CVars::FontAtlasCache.GetValueOnAnyThread() <= 0)
+		{
+			return false;
+		}
+
+		TArray<uint8> Data;
+		if (!FFileHelper::LoadFileToArray(Data, *GetCacheFile(), FILEREAD_Silent))
+		{
+			return false;
+		}
+
+		FCacheReader Reader(Data);
+
+		uint32 Magic, Version, Key, GlyphSize;
+		if (!Reader.Read(Magic) || !Reader.Read(Version) || !Reader.Read(Key) || !Reader.Read(GlyphSize)
+			|| Magic != CacheMagic || Version != CacheVersion || GlyphSize != sizeof(ImFontGlyph)
+			|| Key != ComputeKey(Atlas))
+		{
+			return false;
+		}
+
+		// Read everything before touching the atlas, so it stays intact if cache is corrupted.
+		int32 TexWidth, TexHeight;
+		ImVec2 TexUvWhitePixel;
+		if (!Reader.Read(TexWidth) || !Reader.Read(TexHeight) || !Reader.Read(TexUvWhitePixel)
+			|| TexWidth <= 0 || TexHeight <= 0 || TexWidth > MaxTextureSize || TexHeight > MaxTextureSize)
+		{
+			return false;
+		}
+
+		TArray<FRectPosition> CustomRectPositions;
+		CustomRectPositions.SetNum(Atlas.CustomRects.Size);
+		if (!Reader.ReadBytes(CustomRectPositions.GetData(), CustomRectPositions.Num() * CustomRectPositions.GetTypeSize()))
+		{
+			return false;
+		}
+
+		TArray<FCachedFont> Fonts;
+		Fonts.SetNum(Atlas.Fonts.Size);
+		for (FCachedFont& Font : Fonts)
+		{
+			int32 NumGlyphs;
+			if (!Reader.Read(Font.Ascent) || !Reader.Read(Font.Descent) || !Reader.Read(Font.MetricsTotalSurface)
+				|| !Reader.Read(NumGlyphs) || NumGlyphs < 0 || NumGlyphs >= 0xFFFF)
+			{
+				return false;
+			}
+
+			Font.Glyphs.SetNumUninitialized(NumGlyphs);
+			if (!Reader.ReadBytes(Font.Glyphs.GetData(), NumGlyphs * sizeof(ImFontGlyph)))
+			{
+				return false;
+			}
+		}
+
+		ImGuiMouseCursorData MouseCursorData[ImGuiMouseCursor_Count_];
+		if (!Reader.ReadBytes(MouseCursorData, sizeof(MouseCursorData)))
+		{
+			return false;
+		}
+
+		const int32 NumPixels = TexWidth * TexHeight;
+		unsigned char* Pixels = static_cast<unsigned char*>(ImGui::MemAlloc(NumPixels));
+		if (!Reader.ReadBytes(Pixels, NumPixels) || !Reader.IsAtEnd())
+		{
+			ImGui::MemFree(Pixels);
+			return false;
+		}
+
+		// Restore atlas in the same way as it would be built.
+		Atlas.TexID = nullptr;
+		Atlas.ClearTexData();
+		Atlas.TexPixelsAlpha8 = Pixels;
+		Atlas.TexWidth = TexWidth;
+		Atlas.TexHeight = TexHeight;
+		Atlas.TexUvWhitePixel = TexUvWhitePixel;
+
+		for (int32 Index = 0; Index < Atlas.CustomRects.Size; Index++)
+		{
+			Atlas.CustomRects[Index].X = CustomRectPositions[Index].X;
+			Atlas.CustomRects[Index].Y = CustomRectPositions[Index].Y;
+		}
+
+		for (ImFontConfig& Config : Atlas.ConfigData)
+		{
+			const FCachedFont& Font = Fonts[GetFontIndex(Atlas, Config.DstFont)];
+			ImFontAtlasBuildSetupFont(&Atlas, Config.DstFont, &Config, Font.Ascent, Font.Descent);
+		}
+
+		for (int32 Index = 0; Index < Atlas.Fonts.Size; Index++)
+		{
+			ImFont& Font = *Atlas.Fonts[Index];
+			Font.Glyphs.resize(Fonts[Index].Glyphs.Num());
+			FMemory::Memcpy(Font.Glyphs.Data, Fonts[Index].Glyphs.GetData(), Fonts[Index].Glyphs.Num() * sizeof(ImFontGlyph));
+			Font.MetricsTotalSurface = Fonts[Index].MetricsTotalSurface;
+			Font.BuildLookupTable();
+		}
+
+		FMemory::Memcpy(OutMouseCursorData, MouseCursorData, sizeof(MouseCursorData));
+
+		return true;
+	}
+
+	void Save(const ImFontAtlas& Atlas, const ImGuiMouseCursorData (&MouseCursorData)[ImGuiMouseCursor_Count_])
+	{
+		if (CVars::FontAtlasCache.GetValueOnAnyThread() <= 0 || !Atlas.TexPixelsAlpha8)
+		{
+			return;
+		}
+
+		FCacheWriter Writer;
+
+		Writer.Write(CacheMagic);
+		Writer.Write(CacheVersion);
+		Writer.Write(ComputeKey(Atlas));
+		Writer.Write(static_cast<uint32>(sizeof(ImFontGlyph)));
+
+		Writer.Write(Atlas.TexWidth);
+		Writer.Write(Atlas.TexHeight);
+		Writer.Write(Atlas.TexUvWhitePixel);
+
+		for (const ImFontAtlas::CustomRect& Rect : Atlas.CustomRects)
+		{
+			Writer.Write(FRectPosition{ Rect.X, Rect.Y });
+		}
+
+		for (const ImFont* Font : Atlas.Fonts)
+		{
+			Writer.Write(Font->Ascent);
+			Writer.Write(Font->Descent);
+			Writer.Write(Font->MetricsTotalSurface);
+			Writer.Write(Font->Glyphs.Size);
+			Writer.WriteBytes(Font->Glyphs.Data, Font->Glyphs.Size * sizeof(ImFontGlyph));
+		}
+
+		Writer.WriteBytes(MouseCursorData, sizeof(MouseCursorData));
+		Writer.WriteBytes(Atlas.TexPixelsAlpha8, Atlas.TexWidth * Atlas.TexHeight);
+
+		FFileHelper::SaveArrayToFile(Writer.GetData(), *GetCacheFile());
+	}
+}
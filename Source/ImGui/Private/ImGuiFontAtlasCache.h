@@ -0,0 +1,32 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#pragma once
+
+#include <imgui.h>
+#include <imgui_internal.h>
+
+
+// Persistent cache of built font atlases. Building atlas rasterizes every glyph in configured ranges, what for large
+// ranges (like CJK) can take seconds. Cache stores output of the build (pixels, glyphs, custom rectangles and mouse
+// cursor data) in the project's Saved/ImGui directory, so next time it can be restored without rasterization.
+//
+// Cached atlas is identified by a key, which is a hash of all inputs that affect the build: font data and configs,
+// glyph ranges, custom rectangles and texture settings.
+namespace ImGuiFontAtlasCache
+{
+	// Complete atlas inputs in the same way as ImGui does it before build (add default font if there are no fonts,
+	// set default glyph ranges and register default custom rectangles), so inputs can be hashed.
+	// @param Atlas - Atlas that is going to be built or loaded
+	void PrepareInputs(ImFontAtlas& Atlas);
+
+	// Try to restore atlas from cache. Atlas inputs need to be prepared with PrepareInputs.
+	// @param Atlas - Atlas to restore
+	// @param OutMouseCursorData - Destination for mouse cursor data generated during build
+	// @returns True, if cache matching atlas inputs was found and loaded.
+	bool Load(ImFontAtlas& Atlas, ImGuiMouseCursorData (&OutMouseCursorData)[ImGuiMouseCursor_Count_]);
+
+	// Save built atlas to cache.
+	// @param Atlas - Built atlas
+	// @param MouseCursorData - Mouse cursor data generated during build
+	void Save(const ImFontAtlas& Atlas, const ImGuiMouseCursorData (&MouseCursorData)[ImGuiMouseCursor_Count_]);
+}
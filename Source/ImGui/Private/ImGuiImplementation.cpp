@@ -32,10 +32,20 @@
 #endif // PLATFORM_WINDOWS
 
 
+// With custom GImGui, imgui.cpp doesn't define default context and context pointer, so we need to do it here. Every
+// thread starts with the default context, what matches the ImGui assumption that the current context is never null.
+static ImGuiContext GImDefaultContext;
+
+ImGuiContext*& ImGuiGetThreadContextRef()
+{
+	static thread_local ImGuiContext* ThreadContext = &GImDefaultContext;
+	return ThreadContext;
+}
+
+
 namespace ImGuiImplementation
 {
 	// This is exposing ImGui default context for the whole module.
-	// This is assuming that we don't define custom GImGui and therefore have GImDefaultContext defined in imgui.cpp.
 	ImGuiContext& GetDefaultContext()
 	{
 		return GImDefaultContext;
@@ -45,4 +55,187 @@ namespace ImGuiImplementation
 	{
 		SaveIniSettingsToDisk(Filename);
 	}
+
+	FGlyphPage::FGlyphPage(int32 InWidth, int32 InHeight, int32 Padding)
+		: PackContext(MakeUnique<stbtt_pack_context>())
+		, Width(InWidth)
+		, Height(InHeight)
+	{
+		// Packing context is kept for the whole lifetime of the page, so every call packs glyphs in the remaining space.
+		Pixels.SetNumZeroed(Width * Height);
+		stbtt_PackBegin(PackContext.Get(), Pixels.GetData(), Width, Height, 0, Padding, nullptr);
+	}
+
+	FGlyphPage::~FGlyphPage()
+	{
+		stbtt_PackEnd(PackContext.Get());
+	}
+
+	void FGlyphPage::AddGlyphs(ImFontAtlas& Atlas, ImFontConfig& Config, const TArray<int32>& Codepoints,
+		int32 PageOffsetY, TArray<int32>& OutUnavailable, TArray<int32>& OutNotPacked, FIntRect& InOutDirtyRect)
+	{
+		stbtt_fontinfo FontInfo;
+		const int FontOffset = stbtt_GetFontOffsetForIndex(static_cast<unsigned char*>(Config.FontData), Config.FontNo);
+		if (FontOffset < 0 || !stbtt_InitFont(&FontInfo, static_cast<unsigned char*>(Config.FontData), FontOffset))
+		{
+			OutUnavailable.Append(Codepoints);
+			return;
+		}
+
+		ImFont& Font = *Config.DstFont;
+
+		// Missing glyphs would be packed as empty rectangles, so we filter them out (together with glyphs merged from
+		// other sources).
+		TArray<int32> Available;
+		Available.Reserve(Codepoints.Num());
+		for (int32 Codepoint : Codepoints)
+		{
+			const bool bInFont = Codepoint < Font.IndexLookup.Size && Font.IndexLookup[Codepoint] != (unsigned short)-1;
+			if (bInFont)
+			{
+				continue;
+			}
+
+			if (stbtt_FindGlyphIndex(&FontInfo, Codepoint))
+			{
+				Available.Add(Codepoint);
+			}
+			else
+			{
+				OutUnavailable.Add(Codepoint);
+			}
+		}
+
+		if (Available.Num() == 0)
+		{
+			return;
+		}
+
+		TArray<stbtt_packedchar> PackedChars;
+		PackedChars.SetNumZeroed(Available.Num());
+
+		TArray<stbrp_rect> Rects;
+		Rects.SetNumZeroed(Available.Num());
+
+		stbtt_pack_range Range = {};
+		Range.font_size = Config.SizePixels;
+		Range.array_of_unicode_codepoints = Available.GetData();
+		Range.num_chars = Available.Num();
+		Range.chardata_for_range = PackedChars.GetData();
+
+		// Pack and render the same way as ImGui does it when building atlas.
+		stbtt_PackSetOversampling(PackContext.Get(), Config.OversampleH, Config.OversampleV);
+		const bool bDistanceField = (Config.RasterizerFlags & ImFontRasterizerFlags_SDF) != 0;
+		const int NumRects = stbtt_PackFontRangesGatherRects(PackContext.Get(), &FontInfo, &Range, 1, Rects.GetData());
+		if (bDistanceField)
+		{
+			ImFontAtlasBuildExtendRectsSDF(Rects.GetData(), NumRects);
+		}
+		stbrp_pack_rects(static_cast<stbrp_context*>(PackContext->pack_info), Rects.GetData(), NumRects);
+		stbtt_PackFontRangesRenderIntoRects(PackContext.Get(), &FontInfo, &Range, 1, Rects.GetData());
+
+		unsigned char MultiplyTable[256];
+		if (bDistanceField)
+		{
+			ImFontAtlasBuildConvertToSDF(Pixels.GetData(), Width, &Range, 1, Rects.GetData());
+		}
+		else if (Config.RasterizerMultiply != 1.0f)
+		{
+			ImFontAtlasBuildMultiplyCalcLookupTable(MultiplyTable, Config.RasterizerMultiply);
+		}
+
+		const float OffsetX = Config.GlyphOffset.x;
+		const float OffsetY = Config.GlyphOffset.y + (float)(int)(Font.Ascent + 0.5f);
+
+		for (int32 Index = 0; Index < NumRects; Index++)
+		{
+			const stbrp_rect& Rect = Rects[Index];
+			if (!Rect.was_packed)
+			{
+				OutNotPacked.Add(Available[Index]);
+				continue;
+			}
+
+			if (!bDistanceField && Config.RasterizerMultiply != 1.0f)
+			{
+				ImFontAtlasBuildMultiplyRectAlpha8(MultiplyTable, Pixels.GetData(), Rect.x, Rect.y, Rect.w, Rect.h, Width);
+			}
+
+			const FIntRect GlyphRect{ Rect.x, Rect.y, Rect.x + Rect.w, Rect.y + Rect.h };
+			if (InOutDirtyRect.Area() > 0)
+			{
+				InOutDirtyRect.Union(GlyphRect);
+			}
+			else
+			{
+				InOutDirtyRect = GlyphRect;
+			}
+
+			// Packed positions are relative to this page.
+			stbtt_packedchar PackedChar = PackedChars[Index];
+			PackedChar.y0 += PageOffsetY;
+			PackedChar.y1 += PageOffsetY;
+
+			stbtt_aligned_quad Quad;
+			float DummyX = 0.0f, DummyY = 0.0f;
+			stbtt_GetPackedQuad(&PackedChar, Atlas.TexWidth, Atlas.TexHeight, 0, &DummyX, &DummyY, &Quad, 0);
+
+			// Glyphs are added in reserved space and published in the index after they are complete, so other threads
+			// can use this font at the same time.
+			const int32 Codepoint = Available[Index];
+			check(Font.Glyphs.Size < Font.Glyphs.Capacity && Codepoint < Font.IndexLookup.Size);
+
+			Font.AddGlyph((ImWchar)Codepoint, Quad.x0 + OffsetX, Quad.y0 + OffsetY, Quad.x1 + OffsetX, Quad.y1 + OffsetY,
+				Quad.s0, Quad.t0, Quad.s1, Quad.t1, PackedChar.xadvance);
+
+			FPlatformMisc::MemoryBarrier();
+			Font.IndexAdvanceX[Codepoint] = Font.Glyphs.back().AdvanceX;
+			Font.IndexLookup[Codepoint] = (unsigned short)(Font.Glyphs.Size - 1);
+		}
+	}
+	bool FGlyphPage::AddFont(ImFontAtlas& Atlas, ImFontConfig& Config, int32 PageOffsetY, FIntRect& InOutDirtyRect)
+	{
+		stbtt_fontinfo FontInfo;
+		const int FontOffset = stbtt_GetFontOffsetForIndex(static_cast<unsigned char*>(Config.FontData), Config.FontNo);
+		if (FontOffset < 0 || !stbtt_InitFont(&FontInfo, static_cast<unsigned char*>(Config.FontData), FontOffset))
+		{
+			return false;
+		}
+
+		// Set up font in the same way as ImGui does it when building atlas.
+		const float FontScale = stbtt_ScaleForPixelHeight(&FontInfo, Config.SizePixels);
+		int UnscaledAscent, UnscaledDescent, UnscaledLineGap;
+		stbtt_GetFontVMetrics(&FontInfo, &UnscaledAscent, &UnscaledDescent, &UnscaledLineGap);
+		ImFontAtlasBuildSetupFont(&Atlas, Config.DstFont, &Config, UnscaledAscent * FontScale, UnscaledDescent * FontScale);
+
+		TArray<int32> Codepoints;
+		int32 MaxCodepoint = 0;
+		for (const ImWchar* Range = Config.GlyphRanges; Range[0] && Range[1]; Range += 2)
+		{
+			for (int32 Codepoint = Range[0]; Codepoint <= Range[1]; Codepoint++)
+			{
+				Codepoints.Add(Codepoint);
+			}
+			MaxCodepoint = FMath::Max<int32>(MaxCodepoint, Range[1]);
+		}
+
+		// ImGui indexes glyphs with 16-bit values, with the last one reserved.
+		ImFont& Font = *Config.DstFont;
+		if (Font.Glyphs.Size + Codepoints.Num() >= 0xFFFF)
+		{
+			return false;
+		}
+
+		// Make room for all glyphs, so they can be added with AddGlyphs.
+		Font.Glyphs.reserve(Font.Glyphs.Size + Codepoints.Num());
+		Font.GrowIndex(MaxCodepoint + 1);
+
+		TArray<int32> Unavailable;
+		TArray<int32> NotPacked;
+		AddGlyphs(Atlas, Config, Codepoints, PageOffsetY, Unavailable, NotPacked, InOutDirtyRect);
+
+		Font.BuildLookupTable();
+
+		return NotPacked.Num() == 0;
+	}
 }
\ No newline at end of file
@@ -2,9 +2,14 @@
 
 #pragma once
 
+#include <CoreMinimal.h>
+
 #include <imgui.h>
 
 
+struct stbtt_pack_context;
+
+
 // Gives access to selected ImGui implementation features.
 namespace ImGuiImplementation
 {
@@ -13,4 +18,58 @@ namespace ImGuiImplementation
 
 	// Save current context settings.
 	void SaveCurrentContextIniSettings(const char* Filename);
+
+	// Region of a font atlas, in which glyphs can be rasterized after the atlas is built. It uses font rasterizer and
+	// rectangle packer compiled with ImGui, which are only accessible in the ImGui implementation. Page keeps its own
+	// pixels, which need to be copied to the atlas texture.
+	class FGlyphPage
+	{
+	public:
+
+		// @param Width - Page width in pixels (the same as atlas width)
+		// @param Height - Page height in pixels
+		// @param Padding - Padding between glyphs in pixels
+		FGlyphPage(int32 Width, int32 Height, int32 Padding);
+		~FGlyphPage();
+
+		FGlyphPage(const FGlyphPage&) = delete;
+		FGlyphPage& operator=(const FGlyphPage&) = delete;
+
+		FGlyphPage(FGlyphPage&&) = delete;
+		FGlyphPage& operator=(FGlyphPage&&) = delete;
+
+		// Rasterize glyphs from a font config and add them to its destination font. Font needs to have enough glyph
+		// capacity and index size for new glyphs, so they can be added while other threads use that font.
+		// @param Atlas - Atlas with this page
+		// @param Config - Config of a font to rasterize
+		// @param Codepoints - Codepoints of glyphs to rasterize
+		// @param PageOffsetY - Position of this page in atlas
+		// @param OutUnavailable - Codepoints that are not available in the font (existing content is kept)
+		// @param OutNotPacked - Codepoints of glyphs that didn't fit in this page (existing content is kept)
+		// @param InOutDirtyRect - Rectangle in page pixels, extended to cover pixels changed by this call
+		void AddGlyphs(ImFontAtlas& Atlas, ImFontConfig& Config, const TArray<int32>& Codepoints, int32 PageOffsetY,
+			TArray<int32>& OutUnavailable, TArray<int32>& OutNotPacked, FIntRect& InOutDirtyRect);
+
+		// Set up destination font of a config that was added to the built atlas and rasterize all glyphs from its
+		// ranges. Font is modified without synchronization, so it should not be used by other threads.
+		// @param Atlas - Atlas with this page
+		// @param Config - Config of a font to add (glyph ranges need to be set)
+		// @param PageOffsetY - Position of this page in atlas
+		// @param InOutDirtyRect - Rectangle in page pixels, extended to cover pixels changed by this call
+		// @returns True, if all glyphs fit in this page.
+		bool AddFont(ImFontAtlas& Atlas, ImFontConfig& Config, int32 PageOffsetY, FIntRect& InOutDirtyRect);
+
+		int32 GetWidth() const { return Width; }
+		int32 GetHeight() const { return Height; }
+
+		// Get page pixels, with one byte per pixel.
+		const uint8* GetPixels() const { return Pixels.GetData(); }
+
+	private:
+
+		TArray<uint8> Pixels;
+		TUniquePtr<stbtt_pack_context> PackContext;
+		int32 Width;
+		int32 Height;
+	};
 }
@@ -117,6 +117,13 @@ public:
 	// about dirty parts of keys or mouse buttons arrays.
 	void ClearUpdateState();
 
+	// Check whether there were any key, character, mouse button or mouse wheel updates since the last call to
+	// ClearUpdateState. Mouse position is not tracked in the update state.
+	bool HasUpdateState() const
+	{
+		return InputCharactersNum > 0 || !KeysUpdateRange.IsEmpty() || !MouseButtonsUpdateRange.IsEmpty() || MouseWheelDelta != 0.f;
+	}
+
 private:
 
 	void Reset(bool bKeyboard, bool bMouse);
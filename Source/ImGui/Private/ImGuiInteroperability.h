@@ -77,9 +77,18 @@ namespace ImGuiInterops
 	// Convert from ImGui packed color to FColor.
 	FORCEINLINE FColor UnpackImU32Color(ImU32 Color)
 	{
-		// We use IM_COL32_R/G/B/A_SHIFT macros to support different ImGui configurations.
+		// We use IM_COL32_R/G/B/A_SHIFT macros to support different ImGui configurations. Two common layouts are
+		// handled without unpacking individual channels.
+#if IM_COL32_R_SHIFT == 16 && IM_COL32_G_SHIFT == 8 && IM_COL32_B_SHIFT == 0 && IM_COL32_A_SHIFT == 24
+		// Packed in the same way as FColor.
+		return FColor{ static_cast<uint32>(Color) };
+#elif IM_COL32_R_SHIFT == 0 && IM_COL32_G_SHIFT == 8 && IM_COL32_B_SHIFT == 16 && IM_COL32_A_SHIFT == 24
+		// Default ImGui packing differs from FColor only by swapped red and blue channels.
+		return FColor{ static_cast<uint32>((Color & 0xFF00FF00) | ((Color >> 16) & 0xFF) | ((Color & 0xFF) << 16)) };
+#else
 		return FColor{ (uint8)((Color >> IM_COL32_R_SHIFT) & 0xFF), (uint8)((Color >> IM_COL32_G_SHIFT) & 0xFF),
 			(uint8)((Color >> IM_COL32_B_SHIFT) & 0xFF), (uint8)((Color >> IM_COL32_A_SHIFT) & 0xFF) };
+#endif
 	}
 
 	// Convert from ImVec4 rectangle to FSlateRect.
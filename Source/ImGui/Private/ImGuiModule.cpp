@@ -34,6 +34,27 @@ struct EDelegateCategory
 
 static FImGuiModuleManager* ModuleManager = nullptr;
 
+// Get or create proxy for the context of the current world.
+static FImGuiContextProxy& GetCurrentWorldContextProxy(int32& OutIndex)
+{
+#if WITH_EDITOR
+	checkf(GEngine, TEXT("Null GEngine. Current world should be only accessed with GEngine initialized."));
+
+	const FWorldContext* WorldContext = Utilities::GetWorldContext(GEngine->GameViewport);
+	if (!WorldContext)
+	{
+		WorldContext = Utilities::GetWorldContextFromNetMode(ENetMode::NM_DedicatedServer);
+	}
+
+	checkf(WorldContext, TEXT("Couldn't find current world. World context should be only accessed from a valid world."));
+
+	return ModuleManager->GetContextManager().GetWorldContextProxy(*WorldContext->World(), OutIndex);
+#else
+	OutIndex = Utilities::STANDALONE_GAME_CONTEXT_INDEX;
+	return ModuleManager->GetContextManager().GetWorldContextProxy();
+#endif
+}
+
 #if WITH_EDITOR
 FImGuiDelegateHandle FImGuiModule::AddEditorImGuiDelegate(const FImGuiDelegate& Delegate)
 {
@@ -48,23 +69,8 @@ FImGuiDelegateHandle FImGuiModule::AddWorldImGuiDelegate(const FImGuiDelegate& D
 {
 	checkf(ModuleManager, TEXT("Null pointer to internal module implementation. Is module available?"));
 
-#if WITH_EDITOR
-	checkf(GEngine, TEXT("Null GEngine. AddWorldImGuiDelegate should be only called with GEngine initialized."));
-
-	const FWorldContext* WorldContext = Utilities::GetWorldContext(GEngine->GameViewport);
-	if (!WorldContext)
-	{
-		WorldContext = Utilities::GetWorldContextFromNetMode(ENetMode::NM_DedicatedServer);
-	}
-
-	checkf(WorldContext, TEXT("Couldn't find current world. AddWorldImGuiDelegate should be only called from a valid world."));
-
 	int32 Index;
-	FImGuiContextProxy& Proxy = ModuleManager->GetContextManager().GetWorldContextProxy(*WorldContext->World(), Index);
-#else
-	const int32 Index = Utilities::STANDALONE_GAME_CONTEXT_INDEX;
-	FImGuiContextProxy& Proxy = ModuleManager->GetContextManager().GetWorldContextProxy();
-#endif
+	FImGuiContextProxy& Proxy = GetCurrentWorldContextProxy(Index);
 
 	return{ Proxy.OnDraw().Add(Delegate), EDelegateCategory::Default, Index };
 }
@@ -91,6 +97,62 @@ void FImGuiModule::RemoveImGuiDelegate(const FImGuiDelegateHandle& Handle)
 	}
 }
 
+#if WITH_EDITOR
+FImGuiContextHandle FImGuiModule::GetEditorContextHandle()
+{
+	checkf(ModuleManager, TEXT("Null pointer to internal module implementation. Is module available?"));
+
+	ModuleManager->GetContextManager().GetEditorContextProxy();
+	return FImGuiContextHandle{ Utilities::EDITOR_CONTEXT_INDEX };
+}
+#endif
+
+FImGuiContextHandle FImGuiModule::GetWorldContextHandle()
+{
+	checkf(ModuleManager, TEXT("Null pointer to internal module implementation. Is module available?"));
+
+	int32 Index;
+	GetCurrentWorldContextProxy(Index);
+
+	return FImGuiContextHandle{ Index };
+}
+
+void FImGuiModule::RecordImGuiCommand(const FImGuiContextHandle& Context, FImGuiDeferredCommand Command, int32 SortKey)
+{
+	// Module manager is created and destroyed on the game thread together with this module, so it is safe to use it
+	// from other threads as long as module is loaded.
+	if (ModuleManager && Context.IsValid())
+	{
+		ModuleManager->GetContextManager().GetDeferredCommands().Record(Context.Index, SortKey, MoveTemp(Command));
+	}
+}
+
+ImDrawList* FImGuiModule::BeginPrimitiveDrawList(const FImGuiContextHandle& Context)
+{
+	const FImGuiPrimitiveDrawListsPtr DrawLists = (ModuleManager && Context.IsValid())
+		? ModuleManager->GetContextManager().FindPrimitiveDrawLists(Context.Index) : nullptr;
+	return DrawLists ? DrawLists->Begin() : nullptr;
+}
+
+void FImGuiModule::EndPrimitiveDrawList(ImDrawList* DrawList, int32 LayerKey)
+{
+	FImGuiPrimitiveDrawLists::End(DrawList, LayerKey);
+}
+
+ImFontAtlas& FImGuiModule::GetFontAtlas()
+{
+	checkf(ModuleManager, TEXT("Null pointer to internal module implementation. Is module available?"));
+
+	return ModuleManager->GetFontAtlas().GetAtlas();
+}
+
+ImFont* FImGuiModule::AddFont(const ImFontConfig& FontConfig)
+{
+	checkf(ModuleManager, TEXT("Null pointer to internal module implementation. Is module available?"));
+
+	return ModuleManager->GetFontAtlas().AddFont(FontConfig);
+}
+
 void FImGuiModule::StartupModule()
 {
 	checkf(!ModuleManager, TEXT("Instance of Module Manager already exists. Instance should be created only during module startup."));
@@ -13,6 +13,8 @@
 
 
 FImGuiModuleManager::FImGuiModuleManager()
+	: FontAtlas(TextureManager)
+	, ContextManager(FontAtlas)
 {
 	// Typically we will use viewport created events to add widget to new game viewports.
 	ViewportCreatedHandle = UGameViewportClient::OnViewportCreated().AddRaw(this, &FImGuiModuleManager::OnViewportCreated);
@@ -77,18 +79,8 @@ void FImGuiModuleManager::LoadTextures()
 	// Create an empty texture at index 0. We will use it for ImGui outputs with null texture id.
 	TextureManager.CreatePlainTexture(FName{ "ImGuiModule_Null" }, 2, 2, FColor::White);
 
-	// Create a font atlas texture.
-	ImFontAtlas* Fonts = ImGui::GetIO().Fonts;
-	checkf(Fonts, TEXT("Invalid font atlas."));
-
-	unsigned char* Pixels;
-	int Width, Height, Bpp;
-	Fonts->GetTexDataAsRGBA32(&Pixels, &Width, &Height, &Bpp);
-
-	TextureIndex FontsTexureIndex = TextureManager.CreateTexture(FName{ "ImGuiModule_FontAtlas" }, Width, Height, Bpp, Pixels, false);
-
-	// Set font texture index in ImGui.
-	Fonts->TexID = ImGuiInterops::ToImTextureID(FontsTexureIndex);
+	// Allow shared font atlas to create its texture (it is created as long as there are contexts using that atlas).
+	FontAtlas.EnableTexture();
 }
 
 void FImGuiModuleManager::RegisterTick()
@@ -126,6 +118,13 @@ void FImGuiModuleManager::Tick(float DeltaSeconds)
 {
 	if (IsInUpdateThread())
 	{
+		// Frames ended asynchronously use fonts, so they need to be complete before fonts can be changed.
+		ContextManager.WaitForFrameEnds();
+
+		// Add fonts deferred since the last tick and rasterize glyphs requested in the last frame, so contexts can use
+		// them in the next one.
+		FontAtlas.Tick();
+
 		// Update context manager to advance all ImGui contexts to the next frame.
 		ContextManager.Tick(DeltaSeconds);
 
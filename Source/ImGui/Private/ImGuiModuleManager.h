@@ -3,6 +3,7 @@
 #pragma once
 
 #include "ImGuiContextManager.h"
+#include "ImGuiSharedFontAtlas.h"
 #include "SImGuiWidget.h"
 #include "TextureManager.h"
 
@@ -18,6 +19,9 @@ public:
 	// Get ImGui contexts manager.
 	FImGuiContextManager& GetContextManager() { return ContextManager; }
 
+	// Get font atlas shared by all ImGui contexts.
+	FImGuiSharedFontAtlas& GetFontAtlas() { return FontAtlas; }
+
 	// Get texture resources manager.
 	IMGUI_API FTextureManager& GetTextureManager() { return TextureManager; }
 
@@ -55,12 +59,16 @@ private:
 	// Event that we call after ImGui is updated.
 	FSimpleMulticastDelegate PostImGuiUpdateEvent;
 
-	// Manager for ImGui contexts.
-	FImGuiContextManager ContextManager;
-
 	// Manager for textures resources.
 	FTextureManager TextureManager;
 
+	// Font atlas shared by contexts. Contexts release their references when they are destroyed, so both atlas and
+	// texture manager need to outlive the context manager.
+	FImGuiSharedFontAtlas FontAtlas;
+
+	// Manager for ImGui contexts.
+	FImGuiContextManager ContextManager;
+
 	// Slate widgets that we created.
 	TArray<TWeakPtr<SImGuiWidget>> Widgets;
 
@@ -0,0 +1,126 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#include "ImGuiPrimitiveDrawLists.h"
+
+#include "ImGuiPrivatePCH.h"
+
+#include "ImGuiImplementation.h"
+
+#include <imgui_internal.h>
+
+
+namespace
+{
+	// Context used by threads that emit primitives without having their own context. It is never used to build
+	// frames, only to track allocations without racing with other threads.
+	ImGuiContext& GetThreadScratchContext()
+	{
+		static thread_local ImGuiContext ScratchContext;
+		return ScratchContext;
+	}
+}
+
+
+FImGuiPrimitiveDrawLists::FImGuiPrimitiveDrawLists(const ImDrawListSharedData* InSharedData)
+	: SharedData(InSharedData)
+{
+}
+
+FImGuiPrimitiveDrawLists::~FImGuiPrimitiveDrawLists()
+{
+	// Lists in use keep the pool alive, so at this point all lists are in the pool.
+	TArray<FPrimitiveDrawList*> DrawLists;
+	FreeLists.PopAll(DrawLists);
+	PublishedLists.PopAll(DrawLists);
+
+	for (FPrimitiveDrawList* DrawList : DrawLists)
+	{
+		delete DrawList;
+	}
+}
+
+ImDrawList* FImGuiPrimitiveDrawLists::Begin()
+{
+	if (ImGui::GetCurrentContext() == &ImGuiImplementation::GetDefaultContext() && !IsInGameThread())
+	{
+		ImGuiContext& ScratchContext = GetThreadScratchContext();
+		ScratchContext.IO.MemAllocFn = ImGuiImplementation::GetDefaultContext().IO.MemAllocFn;
+		ScratchContext.IO.MemFreeFn = ImGuiImplementation::GetDefaultContext().IO.MemFreeFn;
+		ImGui::SetCurrentContext(&ScratchContext);
+	}
+
+	FPrimitiveDrawList* DrawList = FreeLists.Pop();
+	if (!DrawList)
+	{
+		DrawList = new FPrimitiveDrawList(SharedData);
+	}
+	DrawList->Owner = AsShared();
+
+	// Match the state in which ImGui windows start drawing. Font is set by the context when it begins frames and it
+	// is the same in every frame.
+	DrawList->Clear();
+	DrawList->PushClipRectFullScreen();
+	DrawList->PushTextureID(SharedData->Font ? SharedData->Font->ContainerAtlas->TexID : nullptr);
+
+	return DrawList;
+}
+
+void FImGuiPrimitiveDrawLists::End(ImDrawList* DrawList, int32 LayerKey)
+{
+	if (!DrawList)
+	{
+		return;
+	}
+
+	FPrimitiveDrawList* PrimitiveDrawList = static_cast<FPrimitiveDrawList*>(DrawList);
+
+	// Release reference to the pool only after the list is given back, so the pool cannot be destroyed in between.
+	const FImGuiPrimitiveDrawListsPtr Owner = MoveTemp(PrimitiveDrawList->Owner);
+
+	// Remove trailing command if unused (the same what ImGui does with window lists).
+	if (PrimitiveDrawList->CmdBuffer.Size > 0 && PrimitiveDrawList->CmdBuffer.back().ElemCount == 0
+		&& PrimitiveDrawList->CmdBuffer.back().UserCallback == nullptr)
+	{
+		PrimitiveDrawList->CmdBuffer.pop_back();
+	}
+
+	if (PrimitiveDrawList->CmdBuffer.Size > 0)
+	{
+		PrimitiveDrawList->LayerKey = LayerKey;
+		Owner->PublishedLists.Push(PrimitiveDrawList);
+	}
+	else
+	{
+		Owner->FreeLists.Push(PrimitiveDrawList);
+	}
+}
+
+void FImGuiPrimitiveDrawLists::Acquire(TArray<ImDrawList*>& OutDrawLists, int32& OutNumBackgroundLists)
+{
+	TArray<FPrimitiveDrawList*> DrawLists;
+	PublishedLists.PopAll(DrawLists);
+
+	DrawLists.StableSort([](const FPrimitiveDrawList& Lhs, const FPrimitiveDrawList& Rhs)
+	{
+		return Lhs.LayerKey < Rhs.LayerKey;
+	});
+
+	OutDrawLists.Reset(DrawLists.Num());
+	OutNumBackgroundLists = 0;
+	for (FPrimitiveDrawList* DrawList : DrawLists)
+	{
+		OutDrawLists.Add(DrawList);
+		if (DrawList->LayerKey < 0)
+		{
+			OutNumBackgroundLists++;
+		}
+	}
+}
+
+void FImGuiPrimitiveDrawLists::Release(const TArray<ImDrawList*>& DrawLists)
+{
+	for (ImDrawList* DrawList : DrawLists)
+	{
+		FreeLists.Push(static_cast<FPrimitiveDrawList*>(DrawList));
+	}
+}
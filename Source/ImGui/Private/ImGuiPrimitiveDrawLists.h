@@ -0,0 +1,75 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#pragma once
+
+#include <Containers/LockFreeList.h>
+#include <Templates/SharedPointer.h>
+
+#include <imgui.h>
+
+
+// Pool of draw lists, in which any thread can emit raw primitives to be rendered together with a single ImGui
+// context. Lists share draw list data of their context, what allows to use atlas and default font.
+//
+// Every thread takes its own list from the pool, so threads don't contend with each other when emitting primitives.
+// Completed lists are published to a lock-free list and taken by the context when it ends the frame.
+//
+// Pools are shared with threads that emit primitives, and lists that are in use keep their pool alive, so it is safe
+// to end them after the owning context is destroyed.
+class FImGuiPrimitiveDrawLists : public TSharedFromThis<FImGuiPrimitiveDrawLists, ESPMode::ThreadSafe>
+{
+public:
+
+	// @param InSharedData - Draw list data of the context that owns this pool
+	explicit FImGuiPrimitiveDrawLists(const ImDrawListSharedData* InSharedData);
+	~FImGuiPrimitiveDrawLists();
+
+	FImGuiPrimitiveDrawLists(const FImGuiPrimitiveDrawLists&) = delete;
+	FImGuiPrimitiveDrawLists& operator=(const FImGuiPrimitiveDrawLists&) = delete;
+
+	FImGuiPrimitiveDrawLists(FImGuiPrimitiveDrawLists&&) = delete;
+	FImGuiPrimitiveDrawLists& operator=(FImGuiPrimitiveDrawLists&&) = delete;
+
+	// Get an empty draw list, with full-screen clipping rectangle and font atlas texture. Can be called from any
+	// thread and the list can be used without synchronization until it is passed to End.
+	//
+	// Lists allocate memory through ImGui, which tracks allocations in the current context. Threads that don't have
+	// their own context share the default one, so on those threads this sets a thread-private scratch context as
+	// current. Lists should be used on the thread that called Begin.
+	ImDrawList* Begin();
+
+	// Publish a list, so it is rendered in the next frame of the context. Can be called from any thread.
+	// @param DrawList - List from Begin of any pool
+	// @param LayerKey - Key defining rendering order of lists (lists with lower keys are rendered first)
+	static void End(ImDrawList* DrawList, int32 LayerKey);
+
+	// Take all published lists sorted by their layer keys. Lists need to be given back with Release.
+	// @param OutDrawLists - Destination array (old content is replaced)
+	// @param OutNumBackgroundLists - Number of leading lists with negative keys, which should be rendered before ImGui
+	//     windows (remaining lists should be rendered after them)
+	void Acquire(TArray<ImDrawList*>& OutDrawLists, int32& OutNumBackgroundLists);
+
+	// Give back lists taken with Acquire, so they can be reused.
+	void Release(const TArray<ImDrawList*>& DrawLists);
+
+private:
+
+	struct FPrimitiveDrawList : public ImDrawList
+	{
+		explicit FPrimitiveDrawList(const ImDrawListSharedData* SharedData)
+			: ImDrawList(SharedData)
+		{
+		}
+
+		// Pool that gave this list, set only while the list is in use (lists in pools don't keep them alive).
+		TSharedPtr<FImGuiPrimitiveDrawLists, ESPMode::ThreadSafe> Owner;
+		int32 LayerKey = 0;
+	};
+
+	const ImDrawListSharedData* SharedData;
+
+	TLockFreePointerListUnordered<FPrimitiveDrawList, PLATFORM_CACHE_LINE_SIZE> FreeLists;
+	TLockFreePointerListUnordered<FPrimitiveDrawList, PLATFORM_CACHE_LINE_SIZE> PublishedLists;
+};
+
+typedef TSharedPtr<FImGuiPrimitiveDrawLists, ESPMode::ThreadSafe> FImGuiPrimitiveDrawListsPtr;
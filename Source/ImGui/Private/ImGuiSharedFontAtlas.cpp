@@ -0,0 +1,455 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#include "ImGuiSharedFontAtlas.h"
+
+#include "ImGuiPrivatePCH.h"
+
+#include "ImGuiFontAtlasCache.h"
+#include "ImGuiImplementation.h"
+#include "ImGuiInteroperability.h"
+#include "ImGuiShaders.h"
+
+#include <Async/ParallelFor.h>
+
+
+DEFINE_LOG_CATEGORY_STATIC(LogImGuiFontAtlas, Log, All);
+
+namespace CVars
+{
+	TAutoConsoleVariable<int> AlphaFontAtlas(TEXT("ImGui.AlphaFontAtlas"), 0,
+		TEXT("Whether font atlas texture should be created with a single channel, rather than expanded to RGBA.\n")
+		TEXT("Alpha textures cannot be drawn by Slate, so in this mode ImGui output is always drawn with ImGui shaders.\n")
+		TEXT("Can only be set in configuration files, before atlas texture is created.\n")
+		TEXT("0: disabled, atlas is uploaded as an RGBA texture (default)\n")
+		TEXT("1: enabled, atlas is uploaded as a PF_G8 texture (requires ImGui shaders)"),
+		ECVF_ReadOnly);
+
+	TAutoConsoleVariable<int> DistanceFieldFonts(TEXT("ImGui.DistanceFieldFonts"), 0,
+		TEXT("Whether glyphs should be rendered as signed distance fields, so fonts can be scaled without losing sharpness.\n")
+		TEXT("Distance fields cannot be drawn by Slate, so in this mode ImGui output is always drawn with ImGui shaders.\n")
+		TEXT("Can only be set in configuration files, before atlas is built.\n")
+		TEXT("0: disabled, glyphs are rendered as coverage (default)\n")
+		TEXT("1: enabled, glyphs are rendered as distance fields (requires ImGui shaders)"),
+		ECVF_ReadOnly);
+
+	TAutoConsoleVariable<int> ParallelFontBuild(TEXT("ImGui.ParallelFontBuild"), 1,
+		TEXT("Whether glyphs should be rasterized in parallel when font atlas is built. Glyphs are packed on the game\n")
+		TEXT("thread, so the atlas is the same in both modes.\n")
+		TEXT("0: disabled, glyphs are rasterized on the game thread\n")
+		TEXT("1: enabled, glyphs are rasterized on the task graph (default)"),
+		ECVF_Default);
+}
+
+#if IMGUI_USE_PARALLEL_FONT_BUILD
+void ImGuiFontBuildParallelFor(int Count, void (*Func)(void* UserData, int Index), void* UserData)
+{
+	const bool bForceSingleThread = CVars::ParallelFontBuild.GetValueOnAnyThread() <= 0;
+	ParallelFor(Count, [Func, UserData](int32 Index) { Func(UserData, Index); }, bForceSingleThread);
+}
+#endif // IMGUI_USE_PARALLEL_FONT_BUILD
+
+namespace
+{
+	// Atlas pixels are released on the render thread after upload. ImGui::MemFree would update allocation metrics of
+	// the render thread's current context, so we use the free function directly.
+	void FreeAtlasPixels(uint8* Pixels)
+	{
+		ImGuiImplementation::GetDefaultContext().IO.MemFreeFn(Pixels);
+	}
+
+	void EnableDistanceField(ImFontConfig& Config)
+	{
+		// Distance fields are scaled rather than positioned with sub-pixel precision, so they don't need oversampling.
+		Config.RasterizerFlags |= ImFontRasterizerFlags_SDF;
+		Config.OversampleH = 1;
+		Config.OversampleV = 1;
+	}
+
+	// Lock taken for reading by text functions (through font access hooks) and for writing when fonts are reallocated.
+	// There is only one shared atlas, so one lock is enough.
+	FRWLock FontsLock;
+
+	// Depth of nested font accesses on this thread. Only the outermost access takes the lock, so text functions can
+	// call each other and the thread that locked fonts for writing can still use them.
+	thread_local int32 FontAccessDepth = 0;
+
+	// Lock fonts for writing. This waits only until other threads leave text functions.
+	class FFontsWriteScope
+	{
+	public:
+
+		FFontsWriteScope()
+		{
+			check(FontAccessDepth == 0);
+			FontsLock.WriteLock();
+			FontAccessDepth++;
+		}
+
+		~FFontsWriteScope()
+		{
+			FontAccessDepth--;
+			FontsLock.WriteUnlock();
+		}
+	};
+}
+
+#if IMGUI_USE_FONT_ACCESS_HOOKS
+void ImGuiBeginFontAccess()
+{
+	if (FontAccessDepth++ == 0)
+	{
+		FontsLock.ReadLock();
+	}
+}
+
+void ImGuiEndFontAccess()
+{
+	if (--FontAccessDepth == 0)
+	{
+		FontsLock.ReadUnlock();
+	}
+}
+#endif // IMGUI_USE_FONT_ACCESS_HOOKS
+
+FImGuiSharedFontAtlas::FImGuiSharedFontAtlas(FTextureManager& InTextureManager)
+	: TextureManager(InTextureManager)
+{
+}
+
+FImGuiSharedFontAtlas::~FImGuiSharedFontAtlas()
+{
+	checkf(Contexts.Num() == 0, TEXT("Shared font atlas destroyed with %d references."), Contexts.Num());
+}
+
+void FImGuiSharedFontAtlas::AddReference(ImGuiContext& Context)
+{
+	if (!bIsBuilt)
+	{
+		Build(true);
+	}
+
+	Context.IO.Fonts = &Atlas;
+	FMemory::Memcpy(Context.MouseCursorData, MouseCursorData, sizeof(MouseCursorData));
+
+	Contexts.Add(&Context);
+
+	UpdateTexture();
+}
+
+void FImGuiSharedFontAtlas::RemoveReference(ImGuiContext& Context)
+{
+	checkf(Contexts.Contains(&Context), TEXT("Removing reference from shared font atlas that was not added."));
+
+	Contexts.RemoveSingleSwap(&Context);
+	if (Contexts.Num() == 0 && AtlasTextureIndex != INDEX_NONE)
+	{
+		// Contexts without references don't produce draw data, so nothing should use this texture anymore.
+		TextureManager.ReleaseTexture(AtlasTextureIndex);
+		AtlasTextureIndex = INDEX_NONE;
+		Atlas.TexID = nullptr;
+	}
+}
+
+ImFont* FImGuiSharedFontAtlas::AddFont(const ImFontConfig& Config)
+{
+	check(IsInGameThread());
+
+	if (!bIsBuilt)
+	{
+		return Atlas.AddFont(&Config);
+	}
+
+	// Other threads use only fonts and not the font and config arrays of the atlas, so a new font can be appended
+	// without locking. Adding font clears texture data, but if they were not uploaded yet, we want to keep them.
+	unsigned char* Pixels = Atlas.TexPixelsAlpha8;
+	Atlas.TexPixelsAlpha8 = nullptr;
+	ImFont* Font = Atlas.AddFont(&Config);
+	Atlas.TexPixelsAlpha8 = Pixels;
+
+	// Configs could be reallocated, so we need to update pointers to them.
+	for (ImFontConfig& FontConfig : Atlas.ConfigData)
+	{
+		if (!FontConfig.MergeMode)
+		{
+			FontConfig.DstFont->ConfigData = &FontConfig;
+		}
+	}
+
+	ImFontConfig& NewConfig = Atlas.ConfigData.back();
+	if (!NewConfig.GlyphRanges)
+	{
+		NewConfig.GlyphRanges = Atlas.GetGlyphRangesDefault();
+	}
+
+	if (bDistanceFieldFonts)
+	{
+		EnableDistanceField(NewConfig);
+	}
+
+	if (NewConfig.MergeMode)
+	{
+		// Merging reallocates glyphs of a font that can be in use on other threads, so it is deferred to Tick.
+		PendingMergedConfigs.Add(Atlas.ConfigData.Size - 1);
+	}
+	else if (!bRebuildPending)
+	{
+		// New font is not used by other threads yet, so its glyphs can be added immediately.
+		FIntRect DirtyRect;
+		if (DynamicGlyphs.AddFont(Atlas, Atlas.ConfigData.Size - 1, DirtyRect))
+		{
+			AddDirtyRect(DirtyRect);
+		}
+		else
+		{
+			bRebuildPending = true;
+		}
+	}
+
+	// Font waiting for rebuild can be used in the meantime, only without glyphs.
+	if (!Font->IsLoaded())
+	{
+		Font->FontSize = NewConfig.SizePixels;
+		Font->ConfigData = &NewConfig;
+		Font->ContainerAtlas = &Atlas;
+	}
+
+	return Font;
+}
+
+void FImGuiSharedFontAtlas::AddDirtyRect(const FIntRect& Rect)
+{
+	// If pixels were not released yet, changes will be uploaded together with the rest of the atlas.
+	if (!Atlas.TexPixelsAlpha8 && Rect.Area() > 0)
+	{
+		if (PendingDirtyRect.Area() > 0)
+		{
+			PendingDirtyRect.Union(Rect);
+		}
+		else
+		{
+			PendingDirtyRect = Rect;
+		}
+	}
+}
+
+void FImGuiSharedFontAtlas::Rebuild()
+{
+	// Draw data that were already produced use the old texture, so we keep it until they are painted (until the next
+	// tick).
+	if (AtlasTextureIndex != INDEX_NONE)
+	{
+		RetiredTextureIndices.Add(AtlasTextureIndex);
+		AtlasTextureIndex = INDEX_NONE;
+		Atlas.TexID = nullptr;
+	}
+
+	// Changes in the old page are not relevant anymore, new texture is created with the whole atlas.
+	PendingDirtyRect = FIntRect{ 0, 0, 0, 0 };
+
+	Build(false);
+
+	// Contexts keep copies of mouse cursor data and white pixel coordinates, which could change when atlas was rebuilt.
+	for (ImGuiContext* Context : Contexts)
+	{
+		FMemory::Memcpy(Context->MouseCursorData, MouseCursorData, sizeof(MouseCursorData));
+		Context->DrawListSharedData.TexUvWhitePixel = Atlas.TexUvWhitePixel;
+	}
+
+	// Create a new texture, so draw events of current frames and next frames use texture coordinates matching their
+	// texture.
+	UpdateTexture();
+}
+
+void FImGuiSharedFontAtlas::EnableTexture()
+{
+	bIsTextureEnabled = true;
+	UpdateTexture();
+}
+
+void FImGuiSharedFontAtlas::UpdateTexture()
+{
+	if (bIsTextureEnabled && Contexts.Num() > 0 && AtlasTextureIndex == INDEX_NONE)
+	{
+		// Pixels are released after every upload, so if texture is recreated, we need to restore them.
+		if (!Atlas.TexPixelsAlpha8)
+		{
+			Build(false);
+		}
+
+		// Glyphs added on demand are kept only in the spare page, so we need to copy them to atlas pixels.
+		DynamicGlyphs.CopyPageToAtlas(Atlas);
+
+#if WITH_IMGUI_SHADERS
+		bAlphaTexture = CVars::AlphaFontAtlas.GetValueOnGameThread() > 0;
+#endif
+
+		// Pixels are taken from atlas and released after upload, so we don't keep CPU copies of the texture.
+		unsigned char* Pixels;
+		int Width, Height, Bpp;
+		EPixelFormat Format;
+		if (bAlphaTexture)
+		{
+			Atlas.GetTexDataAsAlpha8(&Pixels, &Width, &Height, &Bpp);
+			Atlas.TexPixelsAlpha8 = nullptr;
+			Format = PF_G8;
+		}
+		else
+		{
+			Atlas.GetTexDataAsRGBA32(&Pixels, &Width, &Height, &Bpp);
+			Atlas.TexPixelsRGBA32 = nullptr;
+			Format = PF_B8G8R8A8;
+		}
+		Atlas.ClearTexData();
+
+		// Textures of rebuilt atlases can still be registered, so every texture gets a unique name.
+		AtlasTextureIndex = TextureManager.CreateTexture(FName{ TEXT("ImGuiModule_FontAtlas"), ++TextureGeneration },
+			Width, Height, Format, Bpp, Pixels, &FreeAtlasPixels);
+		TextureManager.SetDistanceFieldTexture(AtlasTextureIndex, bDistanceFieldFonts);
+
+		// Set font texture index in ImGui.
+		Atlas.TexID = ImGuiInterops::ToImTextureID(AtlasTextureIndex);
+	}
+}
+
+void FImGuiSharedFontAtlas::Tick()
+{
+	// Draw data that used textures of atlases rebuilt before the last tick were already painted, so they can be
+	// released.
+	for (TextureIndex RetiredTextureIndex : RetiredTextureIndices)
+	{
+		TextureManager.ReleaseTexture(RetiredTextureIndex);
+	}
+	RetiredTextureIndices.Reset();
+
+	if (!bRebuildPending && PendingMergedConfigs.Num() > 0)
+	{
+		// Merging reallocates glyphs, so fonts need to be locked against text functions running on other threads.
+		FFontsWriteScope FontsScope;
+		for (int32 ConfigIndex : PendingMergedConfigs)
+		{
+			FIntRect ConfigRect;
+			if (!DynamicGlyphs.AddFont(Atlas, ConfigIndex, ConfigRect))
+			{
+				bRebuildPending = true;
+				break;
+			}
+			AddDirtyRect(ConfigRect);
+		}
+	}
+	PendingMergedConfigs.Reset();
+
+	if (bRebuildPending)
+	{
+		Rebuild();
+	}
+
+	FIntRect DirtyRect = PendingDirtyRect;
+	PendingDirtyRect = FIntRect{ 0, 0, 0, 0 };
+
+	FIntRect GlyphsRect;
+	if (DynamicGlyphs.Update(Atlas, GlyphsRect))
+	{
+		if (DirtyRect.Area() > 0)
+		{
+			DirtyRect.Union(GlyphsRect);
+		}
+		else
+		{
+			DirtyRect = GlyphsRect;
+		}
+	}
+
+	if (DirtyRect.Area() > 0 && AtlasTextureIndex != INDEX_NONE)
+	{
+		// Without texture, changes will be uploaded together with the whole atlas.
+		UploadRegion(DirtyRect);
+	}
+}
+
+void FImGuiSharedFontAtlas::UploadRegion(const FIntRect& DirtyRect)
+{
+	const int32 Width = DirtyRect.Width();
+	const int32 Height = DirtyRect.Height();
+	const int32 NumPixels = Width * Height;
+
+	uint8* Pixels;
+	uint32 Bpp;
+	if (bAlphaTexture)
+	{
+		Bpp = 1;
+		Pixels = new uint8[NumPixels];
+		DynamicGlyphs.CopyPageRect(DirtyRect, Pixels);
+	}
+	else
+	{
+		// Expand alpha to white RGBA pixels, in the same way as ImFontAtlas::GetTexDataAsRGBA32. Alpha is copied to
+		// the end of the buffer, so it can be expanded in place without overwriting values that are not read yet.
+		Bpp = 4;
+		Pixels = new uint8[NumPixels * Bpp];
+		uint8* Alpha = Pixels + NumPixels * (Bpp - 1);
+		DynamicGlyphs.CopyPageRect(DirtyRect, Alpha);
+
+		uint32* Colors = reinterpret_cast<uint32*>(Pixels);
+		for (int32 Index = 0; Index < NumPixels; Index++)
+		{
+			Colors[Index] = IM_COL32(255, 255, 255, Alpha[Index]);
+		}
+	}
+
+	TextureManager.UpdateTextureRegion(AtlasTextureIndex, DirtyRect.Min.X, DirtyRect.Min.Y, Width, Height, Bpp, Pixels,
+		[](uint8* Data) { delete[] Data; });
+}
+
+void FImGuiSharedFontAtlas::Build(bool bSaveToCache)
+{
+	// Building resets all fonts, so they cannot be used by other threads in the meantime.
+	FFontsWriteScope FontsScope;
+
+	// Atlas is built with all configs, so changes deferred by AddFont are not needed anymore.
+	PendingMergedConfigs.Reset();
+	bRebuildPending = false;
+
+	// Building atlas writes mouse cursor data to the current context. We build it in the default context and keep
+	// a copy of those data for contexts that use this atlas.
+	ImGuiContext* PreviousContext = ImGui::GetCurrentContext();
+	ImGuiContext& DefaultContext = ImGuiImplementation::GetDefaultContext();
+	ImGui::SetCurrentContext(&DefaultContext);
+
+	// Try to restore atlas from disk cache, before falling back to rasterizing all glyphs.
+	ImGuiFontAtlasCache::PrepareInputs(Atlas);
+
+#if WITH_IMGUI_SHADERS
+	bDistanceFieldFonts = CVars::DistanceFieldFonts.GetValueOnGameThread() > 0;
+#endif
+	if (bDistanceFieldFonts)
+	{
+		for (ImFontConfig& Config : Atlas.ConfigData)
+		{
+			EnableDistanceField(Config);
+		}
+	}
+
+	// Limit large ranges to glyphs built with atlas, before inputs are hashed by cache.
+	DynamicGlyphs.PrepareInputs(Atlas);
+
+	if (!ImGuiFontAtlasCache::Load(Atlas, MouseCursorData))
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		Atlas.Build();
+		UE_LOG(LogImGuiFontAtlas, Log, TEXT("Font atlas %dx%d built in %.2f ms (parallel build: %s)."), Atlas.TexWidth,
+			Atlas.TexHeight, (FPlatformTime::Seconds() - StartTime) * 1000.0,
+			(IMGUI_USE_PARALLEL_FONT_BUILD && CVars::ParallelFontBuild.GetValueOnGameThread() > 0) ? TEXT("on") : TEXT("off"));
+
+		FMemory::Memcpy(MouseCursorData, DefaultContext.MouseCursorData, sizeof(MouseCursorData));
+		if (bSaveToCache)
+		{
+			ImGuiFontAtlasCache::Save(Atlas, MouseCursorData);
+		}
+	}
+
+	DynamicGlyphs.Initialize(Atlas, MouseCursorData);
+
+	bIsBuilt = true;
+
+	ImGui::SetCurrentContext(PreviousContext);
+}
@@ -0,0 +1,119 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#pragma once
+
+#include "ImGuiDynamicGlyphs.h"
+#include "TextureManager.h"
+
+#include <imgui.h>
+#include <imgui_internal.h>
+
+
+// Font atlas shared by all ImGui contexts. Atlas is built once, when the first context is added, and mouse cursor
+// data generated during build are kept, so they can be copied to other contexts without building atlas again.
+//
+// Contexts are counted as references. Atlas texture is created when there are references and texture creation is
+// enabled and it is released when the last reference is removed.
+//
+// Glyphs of fonts with large ranges are rasterized on demand (see FImGuiDynamicGlyphs) and uploaded during Tick. Fonts
+// added after atlas is built are rasterized into free space at the bottom of the atlas, and atlas is only rebuilt if
+// they don't fit there.
+//
+// Fonts can be used outside of the game thread (in primitive draw lists and in frames ended asynchronously). Changes
+// that reallocate fonts which can be in use (merging configs into existing fonts and rebuilding atlas) are deferred to
+// Tick, after frames ended asynchronously are complete, and they lock fonts only against text functions that run at
+// the same time on other threads (see IMGUI_USE_FONT_ACCESS_HOOKS).
+class FImGuiSharedFontAtlas
+{
+public:
+
+	// @param InTextureManager - Texture manager used to create atlas texture (needs to outlive this object)
+	explicit FImGuiSharedFontAtlas(FTextureManager& InTextureManager);
+	~FImGuiSharedFontAtlas();
+
+	FImGuiSharedFontAtlas(const FImGuiSharedFontAtlas&) = delete;
+	FImGuiSharedFontAtlas& operator=(const FImGuiSharedFontAtlas&) = delete;
+
+	FImGuiSharedFontAtlas(FImGuiSharedFontAtlas&&) = delete;
+	FImGuiSharedFontAtlas& operator=(FImGuiSharedFontAtlas&&) = delete;
+
+	// Get the shared atlas.
+	ImFontAtlas& GetAtlas() { return Atlas; }
+
+	// Set this atlas in context IO and copy mouse cursor data to that context. Builds atlas if needed.
+	// @param Context - Context that should use this atlas
+	void AddReference(ImGuiContext& Context);
+
+	// Remove reference added with AddReference.
+	// @param Context - Context that used this atlas
+	void RemoveReference(ImGuiContext& Context);
+
+	// Add a font to the atlas. Before atlas is built, font is only added to its inputs. After that, glyphs of a new
+	// font are rasterized into free atlas space and only the changed region of the texture is uploaded during Tick.
+	// Configs merged into existing fonts and fonts that don't fit are added during Tick. If they don't fit, atlas is
+	// rebuilt and a new texture is created (the old one is released during the following Tick, after draw data using
+	// it are painted). Should be called on the game thread, outside of ImGui frames.
+	// @param Config - Config of a font to add (font data are copied if they are not owned by atlas)
+	// @returns Added font (or font to which config is merged), which can be used immediately, but which might miss
+	//     glyphs until Tick.
+	ImFont* AddFont(const ImFontConfig& Config);
+
+	// Whether atlas texture cannot be drawn by Slate and needs ImGui shaders (it is a single-channel texture or it
+	// stores distance fields).
+	bool RequiresImGuiShaders() const { return (bAlphaTexture || bDistanceFieldFonts) && AtlasTextureIndex != INDEX_NONE; }
+
+	// Allow to create atlas texture. Should be called when texture manager can create textures, after textures with
+	// reserved indices are created.
+	void EnableTexture();
+
+	// Release textures of atlases that were rebuilt before the last tick, add fonts deferred by AddFont, rasterize
+	// glyphs requested since the last tick and upload changed part of the atlas texture. Should be called on the game
+	// thread, after frames ended asynchronously are complete and before contexts are ticked.
+	void Tick();
+
+private:
+
+	// Add a rectangle changed in atlas to changes that are uploaded during Tick.
+	void AddDirtyRect(const FIntRect& Rect);
+
+	// Create atlas texture if it is enabled, there are references and it doesn't exist yet.
+	void UpdateTexture();
+
+	// Upload a region of atlas, which is inside of the spare page.
+	void UploadRegion(const FIntRect& Rect);
+
+	// Rebuild atlas with all its fonts and switch to a new texture.
+	void Rebuild();
+
+	// Build atlas or restore it from cache. Locks fonts against other threads.
+	// @param bSaveToCache - Whether built atlas should be saved to cache (inputs of runtime rebuilds are not stable,
+	//     so saving them would only overwrite cache of the initial build)
+	void Build(bool bSaveToCache);
+
+	ImFontAtlas Atlas;
+	FImGuiDynamicGlyphs DynamicGlyphs;
+
+	ImGuiMouseCursorData MouseCursorData[ImGuiMouseCursor_Count_];
+	bool bIsBuilt = false;
+
+	FTextureManager& TextureManager;
+	TextureIndex AtlasTextureIndex = INDEX_NONE;
+
+	// Textures of rebuilt atlases, which can still be used by draw data painted before the next tick.
+	TArray<TextureIndex> RetiredTextureIndices;
+	int32 TextureGeneration = 0;
+
+	// Contexts using this atlas (references).
+	TArray<ImGuiContext*> Contexts;
+
+	// Changes made since the last tick, which need to be uploaded.
+	FIntRect PendingDirtyRect{ 0, 0, 0, 0 };
+
+	// Indices of configs merged into existing fonts and whether atlas needs to be rebuilt (changes deferred by AddFont).
+	TArray<int32> PendingMergedConfigs;
+	bool bRebuildPending = false;
+
+	bool bIsTextureEnabled = false;
+	bool bAlphaTexture = false;
+	bool bDistanceFieldFonts = false;
+};
@@ -46,6 +46,44 @@ namespace CVars
 		TEXT("1: enabled, ImGui will take care for drawing mouse cursor"),
 		ECVF_Default);
 
+	TAutoConsoleVariable<int> ParallelConversion(TEXT("ImGui.ParallelConversion"), 0,
+		TEXT("Whether ImGui draw lists should be converted to Slate format in parallel.\n")
+		TEXT("0: disabled, draw lists are converted on the game thread (default)\n")
+		TEXT("1: enabled, draw lists are converted on the task graph if there are enough of them ")
+		TEXT("(see ImGui.ParallelConversion.MinDrawLists)"),
+		ECVF_Default);
+
+	TAutoConsoleVariable<int> ParallelConversionMinDrawLists(TEXT("ImGui.ParallelConversion.MinDrawLists"), 8,
+		TEXT("Minimal number of ImGui draw lists in a frame to convert them in parallel, if ImGui.ParallelConversion ")
+		TEXT("is enabled (default: 8)."),
+		ECVF_Default);
+
+	TAutoConsoleVariable<int> CullTriangles(TEXT("ImGui.CullTriangles"), 0,
+		TEXT("Whether triangles outside of clipping rectangles should be removed before ImGui output is submitted to ")
+		TEXT("Slate. Draw commands that are completely clipped are always removed.\n")
+		TEXT("0: disabled, partially clipped draw commands are submitted with all their triangles (default)\n")
+		TEXT("1: enabled, triangles of partially clipped draw commands are tested and only visible ones are submitted"),
+		ECVF_Default);
+
+	TAutoConsoleVariable<int> CustomRenderer(TEXT("ImGui.CustomRenderer"), 0,
+		TEXT("Whether ImGui output should be rendered on the render thread by a custom Slate element, bypassing Slate ")
+		TEXT("batching.\n")
+		TEXT("0: disabled, ImGui output is converted and submitted to Slate as custom vertices (default)\n")
+		TEXT("1: enabled, ImGui draw data are passed to the render thread and drawn with own buffers"),
+		ECVF_Default);
+
+	TAutoConsoleVariable<int> CachedComposite(TEXT("ImGui.CachedComposite"), 0,
+		TEXT("Whether ImGui output should be rendered to a texture at a limited rate and drawn as a single quad.\n")
+		TEXT("0: disabled, ImGui output is rendered in every frame (default)\n")
+		TEXT("1: enabled, ImGui output is cached in a render target which is refreshed at a rate defined by ")
+		TEXT("ImGui.CachedComposite.RefreshRate or immediately after input"),
+		ECVF_Default);
+
+	TAutoConsoleVariable<float> CachedCompositeRefreshRate(TEXT("ImGui.CachedComposite.RefreshRate"), 15.f,
+		TEXT("Maximal number of times per second that cached ImGui output is refreshed if ImGui.CachedComposite is ")
+		TEXT("enabled. With 0, output is refreshed whenever it changes (default: 15)."),
+		ECVF_Default);
+
 	TAutoConsoleVariable<int> DebugWidget(TEXT("ImGui.Debug.Widget"), 0,
 		TEXT("Show debug for SImGuiWidget.\n")
 		TEXT("0: disabled (default)\n")
@@ -91,6 +129,10 @@ void SImGuiWidget::Construct(const FArguments& InArgs)
 	checkf(ContextProxy, TEXT("Missing context during widget construction: ContextIndex = %d"), ContextIndex);
 	ContextProxy->OnDraw().AddRaw(this, &SImGuiWidget::OnDebugDraw);
 	ContextProxy->SetInputState(&InputState);
+
+	// Frame ended event can be called from a task, so we need to wait for it before changing listeners.
+	ContextProxy->WaitForFrameEnd();
+	ContextProxy->OnFrameEnded().AddRaw(this, &SImGuiWidget::OnContextFrameEnded);
 }
 END_SLATE_FUNCTION_BUILD_OPTIMIZATION
 
@@ -101,6 +143,9 @@ SImGuiWidget::~SImGuiWidget()
 	{
 		ContextProxy->OnDraw().RemoveAll(this);
 		ContextProxy->RemoveInputState(&InputState);
+
+		ContextProxy->WaitForFrameEnd();
+		ContextProxy->OnFrameEnded().RemoveAll(this);
 	}
 
 	// Unregister from post-update notifications.
@@ -426,12 +471,35 @@ void SImGuiWidget::UpdateMouseStatus()
 	}
 }
 
+void SImGuiWidget::OnContextFrameEnded(const TArray<FImGuiDrawList>& DrawLists)
+{
+	// Convert new draw data with parameters from the last paint. In pipelined mode this runs in a task, what hides
+	// the conversion cost behind the rest of the game frame. If parameters don't change, paint reuses these batches.
+	if (bPrepareBatches)
+	{
+		const bool bParallelConversion = PrepareBatchesParallelMinDrawLists >= 0
+			&& DrawLists.Num() >= PrepareBatchesParallelMinDrawLists;
+
+		SlateDrawData.UpdateWithLastParameters(DrawLists, bParallelConversion);
+	}
+}
+
 void SImGuiWidget::OnPostImGuiUpdate()
 {
 	if (InputMode != EInputMode::None)
 	{
 		InputState.ClearUpdateState();
 	}
+
+	// This widget is not volatile, so it can be cached by invalidation panels as long as ImGui output doesn't change.
+	// If it did change since the last paint, we need to invalidate to be repainted.
+	if (FImGuiContextProxy* ContextProxy = ModuleManager->GetContextManager().GetContextProxy(ContextIndex))
+	{
+		if (FImGuiSlateDrawData::ComputeDrawDataHash(ContextProxy->GetDrawData()) != PaintedDrawDataHash)
+		{
+			Invalidate(EInvalidateWidget::Layout);
+		}
+	}
 }
 
 int32 SImGuiWidget::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyClippingRect,
@@ -443,53 +511,112 @@ int32 SImGuiWidget::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeo
 		// keep frame tearing at minimum because it is executed at the very end of the frame.
 		ContextProxy->Tick(FSlateApplication::Get().GetDeltaTime());
 
+		const TArray<FImGuiDrawList>& DrawLists = ContextProxy->GetDrawData();
+		PaintedDrawDataHash = FImGuiSlateDrawData::ComputeDrawDataHash(DrawLists);
+
 		// Calculate offset that will transform vertex positions to screen space - rounded to avoid half pixel offsets.
 		const FVector2D VertexPositionOffset{ FMath::RoundToFloat(MyClippingRect.Left), FMath::RoundToFloat(MyClippingRect.Top) };
 
-		// Convert clipping rectangle to format required by Slate vertex.
-		const FSlateRotatedRect VertexClippingRect{ MyClippingRect };
+		// Batches are only prepared for the default rendering mode.
+		bPrepareBatches = false;
 
-		for (const auto& DrawList : ContextProxy->GetDrawData())
+#if WITH_IMGUI_SHADERS
+		if (CVars::CachedComposite.GetValueOnGameThread() > 0)
 		{
-#if WITH_OBSOLETE_CLIPPING_API
-			DrawList.CopyVertexData(VertexBuffer, VertexPositionOffset, VertexClippingRect);
+			if (!CompositeTarget.IsValid())
+			{
+				CompositeTarget = MakeUnique<FImGuiCompositeTarget>();
+			}
 
-			// Get access to the Slate scissor rectangle defined in Slate Core API, so we can customize elements drawing.
-			extern SLATECORE_API TOptional<FShortRect> GSlateScissorRect;
-			auto GSlateScissorRectSaver = ScopeGuards::MakeStateSaver(GSlateScissorRect);
-#else
-			DrawList.CopyVertexData(VertexBuffer, VertexPositionOffset);
-#endif // WITH_OBSOLETE_CLIPPING_API
+			if (!CompositeTarget->HasLayout(MyClippingRect) || CompositeTarget->GetDrawDataHash() != PaintedDrawDataHash)
+			{
+				// Input forces refresh, so interaction stays responsive.
+				const bool bHasInput = InputMode != EInputMode::None
+					&& (InputState.HasUpdateState() || InputState.GetMousePosition() != CompositeMousePosition);
+
+				const float RefreshRate = CVars::CachedCompositeRefreshRate.GetValueOnGameThread();
+				const bool bRefreshTime = RefreshRate <= 0.f
+					|| FPlatformTime::Seconds() - CompositeTarget->GetRenderTime() >= 1.0 / RefreshRate;
+
+				if (!CompositeTarget->HasLayout(MyClippingRect) || bHasInput || bRefreshTime)
+				{
+					CompositeTarget->Render(DrawLists, PaintedDrawDataHash, ModuleManager->GetTextureManager(),
+						VertexPositionOffset, MyClippingRect);
+					CompositeMousePosition = InputState.GetMousePosition();
+				}
+			}
+
+			// Output that is not rendered yet needs to be painted again, even if it doesn't change.
+			PaintedDrawDataHash = CompositeTarget->GetDrawDataHash();
+
+			if (CompositeTarget->HasLayout(MyClippingRect))
+			{
+				// Render target is cleared to transparent color and ImGui output is blended over it, so its color is
+				// premultiplied by alpha.
+				FSlateDrawElement::MakeBox(OutDrawElements, LayerId, FPaintGeometry{ MyClippingRect.GetTopLeft(), MyClippingRect.GetSize(), 1.f },
+					&CompositeTarget->GetBrush(), ESlateDrawEffect::PreMultipliedAlpha);
+			}
 
-			int IndexBufferOffset = 0;
-			for (int CommandNb = 0; CommandNb < DrawList.NumCommands(); CommandNb++)
+			return LayerId;
+		}
+
+		// Alpha font atlas cannot be drawn by Slate, so it needs custom renderer.
+		if (CVars::CustomRenderer.GetValueOnGameThread() > 0 || ModuleManager->GetFontAtlas().RequiresImGuiShaders())
+		{
+			if (!DrawElement.IsValid())
 			{
-				const auto& DrawCommand = DrawList.GetCommand(CommandNb);
+				DrawElement = MakeShareable(new FImGuiDrawElement());
+			}
+
+			// Custom element draws directly to the window back buffer, so it needs positions relative to the window.
+			const FVector2D WindowOffset = OutDrawElements.GetWindow()->GetPositionInScreen();
+			DrawElement->Update(DrawLists, ModuleManager->GetTextureManager(),
+				VertexPositionOffset - WindowOffset, MyClippingRect.OffsetBy(-WindowOffset));
+
+			FSlateDrawElement::MakeCustom(OutDrawElements, LayerId, DrawElement);
+
+			return LayerId;
+		}
+#endif // WITH_IMGUI_SHADERS
 
-				DrawList.CopyIndexData(IndexBuffer, IndexBufferOffset, DrawCommand.NumElements);
+		// Convert draw lists to Slate format, merging compatible draw commands into batches. Every command is copied to
+		// its own part of the batch buffers, so if there are enough lists we can convert them in parallel. If ImGui
+		// output didn't change since the last frame, previously converted batches are reused.
 
-				// Advance offset by number of copied elements to position it for the next command.
-				IndexBufferOffset += DrawCommand.NumElements;
+		const bool bParallelConversion = CVars::ParallelConversion.GetValueOnGameThread() > 0
+			&& DrawLists.Num() >= CVars::ParallelConversionMinDrawLists.GetValueOnGameThread();
 
-				// Get texture resource handle for this draw command (null index will be also mapped to a valid texture).
-				const FSlateResourceHandle& Handle = ModuleManager->GetTextureManager().GetTextureHandle(DrawCommand.TextureId);
+		SlateDrawData.Update(DrawLists, VertexPositionOffset, MyClippingRect, bParallelConversion,
+			CVars::CullTriangles.GetValueOnGameThread() > 0);
 
-				// Transform clipping rectangle to screen space and apply to elements that we draw.
-				const FSlateRect ClippingRect = DrawCommand.ClippingRect.OffsetBy(MyClippingRect.GetTopLeft()).IntersectionWith(MyClippingRect);
+		bPrepareBatches = true;
+		PrepareBatchesParallelMinDrawLists = CVars::ParallelConversion.GetValueOnGameThread() > 0
+			? FMath::Max(CVars::ParallelConversionMinDrawLists.GetValueOnGameThread(), 0) : INDEX_NONE;
 
 #if WITH_OBSOLETE_CLIPPING_API
-				GSlateScissorRect = FShortRect{ ClippingRect };
+		// Get access to the Slate scissor rectangle defined in Slate Core API, so we can customize elements drawing.
+		extern SLATECORE_API TOptional<FShortRect> GSlateScissorRect;
+		auto GSlateScissorRectSaver = ScopeGuards::MakeStateSaver(GSlateScissorRect);
+#endif // WITH_OBSOLETE_CLIPPING_API
+
+		for (const auto& SlateCommand : SlateDrawData.GetBatches())
+		{
+			// Get texture resource handle for this draw command (null index will be also mapped to a valid texture).
+			const FSlateResourceHandle& Handle = ModuleManager->GetTextureManager().GetTextureHandle(SlateCommand.TextureId);
+
+			// Apply clipping rectangle to elements that we draw.
+#if WITH_OBSOLETE_CLIPPING_API
+			GSlateScissorRect = FShortRect{ SlateCommand.ClippingRect };
 #else
-				OutDrawElements.PushClip(FSlateClippingZone{ ClippingRect });
+			OutDrawElements.PushClip(FSlateClippingZone{ SlateCommand.ClippingRect });
 #endif // WITH_OBSOLETE_CLIPPING_API
 
-				// Add elements to the list.
-				FSlateDrawElement::MakeCustomVerts(OutDrawElements, LayerId, Handle, VertexBuffer, IndexBuffer, nullptr, 0, 0);
+			// Add elements to the list.
+			FSlateDrawElement::MakeCustomVerts(OutDrawElements, LayerId, Handle, SlateCommand.VertexBuffer, SlateCommand.IndexBuffer, nullptr, 0, 0);
 
 #if !WITH_OBSOLETE_CLIPPING_API
-				OutDrawElements.PopClip();
+			OutDrawElements.PopClip();
 #endif // WITH_OBSOLETE_CLIPPING_API
-			}
 		}
 	}
 
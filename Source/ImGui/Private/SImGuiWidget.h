@@ -3,6 +3,9 @@
 #pragma once
 
 #include "Widgets/SLeafWidget.h"
+#include "ImGuiDrawData.h"
+#include "ImGuiCompositeTarget.h"
+#include "ImGuiDrawElement.h"
 #include "ImGuiInputState.h"
 
 #include "Widgets/DeclarativeSyntaxSupport.h"
@@ -108,6 +111,9 @@ private:
 
 	void OnPostImGuiUpdate();
 
+	// Called on the thread that ends the context frame (see FImGuiContextProxy::OnFrameEnded).
+	void OnContextFrameEnded(const TArray<FImGuiDrawList>& DrawLists);
+
 	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyClippingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& WidgetStyle, bool bParentEnabled) const override;
 
 	virtual FVector2D ComputeDesiredSize(float) const override;
@@ -117,8 +123,27 @@ private:
 	FImGuiModuleManager* ModuleManager = nullptr;
 	TWeakObjectPtr<UGameViewportClient> GameViewport;
 
-	mutable TArray<FSlateVertex> VertexBuffer;
-	mutable TArray<SlateIndex> IndexBuffer;
+	// Draw data converted to Slate format. Kept between frames to reuse allocations.
+	mutable FImGuiSlateDrawData SlateDrawData;
+
+	// Hash of draw data from the last paint, used to detect when this widget needs to be invalidated.
+	mutable uint64 PaintedDrawDataHash = 0;
+
+	// Whether batches should be prepared as soon as the context ends its frame and the minimum number of draw lists
+	// to do that in parallel (negative, if parallel conversion is disabled). Set during paint, which uses batches.
+	mutable bool bPrepareBatches = false;
+	mutable int32 PrepareBatchesParallelMinDrawLists = INDEX_NONE;
+
+#if WITH_IMGUI_SHADERS
+	// Custom element rendering ImGui output on the render thread, created on demand.
+	mutable TSharedPtr<FImGuiDrawElement, ESPMode::ThreadSafe> DrawElement;
+
+	// Render target with cached ImGui output, created on demand.
+	mutable TUniquePtr<FImGuiCompositeTarget> CompositeTarget;
+
+	// Mouse position when composite target was rendered the last time, used to detect input.
+	mutable FVector2D CompositeMousePosition = FVector2D::ZeroVector;
+#endif // WITH_IMGUI_SHADERS
 
 	int32 ContextIndex = 0;
 
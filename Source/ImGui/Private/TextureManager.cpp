@@ -8,29 +8,65 @@
 
 
 TextureIndex FTextureManager::CreateTexture(const FName& Name, int32 Width, int32 Height, uint32 SrcBpp, uint8* SrcData, bool bDeleteSrcData)
+{
+	return CreateTexture(Name, Width, Height, PF_B8G8R8A8, SrcBpp, SrcData, [bDeleteSrcData](uint8* Data)
+	{
+		if (bDeleteSrcData)
+		{
+			delete[] Data;
+		}
+	});
+}
+
+TextureIndex FTextureManager::CreateTexture(const FName& Name, int32 Width, int32 Height, EPixelFormat Format, uint32 SrcBpp,
+	uint8* SrcData, TFunction<void(uint8*)> SrcDataCleanup)
 {
 	checkf(FindTextureIndex(Name) == INDEX_NONE, TEXT("Trying to create texture using resource name '%s' that is already registered."), *Name.ToString());
 
 	// Create a texture.
-	UTexture2D* Texture = UTexture2D::CreateTransient(Width, Height);
+	UTexture2D* Texture = UTexture2D::CreateTransient(Width, Height, Format);
+
+	// Single-channel textures store linear coverage, which should not be converted from sRGB when sampled.
+	if (Format == PF_G8)
+	{
+		Texture->SRGB = false;
+	}
 
 	// Create a new resource for that texture.
 	Texture->UpdateResource();
 
 	// Update texture data.
 	FUpdateTextureRegion2D* TextureRegion = new FUpdateTextureRegion2D(0, 0, 0, 0, Width, Height);
-	auto DataCleanup = [bDeleteSrcData](uint8* Data, const FUpdateTextureRegion2D* UpdateRegion)
+	auto DataCleanup = [SrcDataCleanup](uint8* Data, const FUpdateTextureRegion2D* UpdateRegion)
 	{
-		if (bDeleteSrcData)
+		if (SrcDataCleanup)
 		{
-			delete Data;
+			SrcDataCleanup(Data);
 		}
 		delete UpdateRegion;
 	};
 	Texture->UpdateTextureRegions(0, 1u, TextureRegion, SrcBpp * Width, SrcBpp, SrcData, DataCleanup);
 
 	// Create a new entry for the texture.
-	return TextureResources.Emplace(Name, Texture);
+	return AddEntry(Name, Texture, Format == PF_G8);
+}
+
+void FTextureManager::UpdateTextureRegion(TextureIndex Index, int32 X, int32 Y, int32 Width, int32 Height, uint32 SrcBpp,
+	uint8* SrcData, TFunction<void(uint8*)> SrcDataCleanup)
+{
+	UTexture2D* Texture = TextureResources[Index].Texture;
+	checkf(Texture, TEXT("Trying to update texture at index %d that was released."), Index);
+
+	FUpdateTextureRegion2D* TextureRegion = new FUpdateTextureRegion2D(X, Y, 0, 0, Width, Height);
+	auto DataCleanup = [SrcDataCleanup](uint8* Data, const FUpdateTextureRegion2D* UpdateRegion)
+	{
+		if (SrcDataCleanup)
+		{
+			SrcDataCleanup(Data);
+		}
+		delete UpdateRegion;
+	};
+	Texture->UpdateTextureRegions(0, 1u, TextureRegion, SrcBpp * Width, SrcBpp, SrcData, DataCleanup);
 }
 
 TextureIndex FTextureManager::CreatePlainTexture(const FName& Name, int32 Width, int32 Height, FColor Color)
@@ -47,10 +83,51 @@ TextureIndex FTextureManager::CreatePlainTexture(const FName& Name, int32 Width,
 	return CreateTexture(Name, Width, Height, Bpp, SrcData, true);
 }
 
-FTextureManager::FTextureEntry::FTextureEntry(const FName& InName, UTexture2D* InTexture)
-	: Name{ InName }
-	, Texture{ InTexture }
+TextureIndex FTextureManager::AddTexture(const FName& Name, UTexture2D* Texture)
+{
+	return AddEntry(Name, Texture, false);
+}
+
+void FTextureManager::ReleaseTexture(TextureIndex Index)
+{
+	FTextureEntry& Entry = TextureResources[Index];
+	if (Entry.Texture)
+	{
+		Entry.Reset();
+		ReleasedIndices.Add(Index);
+	}
+}
+
+TextureIndex FTextureManager::AddEntry(const FName& Name, UTexture2D* Texture, bool bAlphaTexture)
+{
+	if (ReleasedIndices.Num() > 0)
+	{
+		const TextureIndex Index = ReleasedIndices.Pop(false);
+		TextureResources[Index].Set(Name, Texture, bAlphaTexture);
+		return Index;
+	}
+
+	return TextureResources.Emplace(Name, Texture, bAlphaTexture);
+}
+
+FTextureManager::FTextureEntry::FTextureEntry(const FName& InName, UTexture2D* InTexture, bool bInAlphaTexture)
 {
+	Set(InName, InTexture, bInAlphaTexture);
+}
+
+FTextureManager::FTextureEntry::~FTextureEntry()
+{
+	Reset();
+}
+
+void FTextureManager::FTextureEntry::Set(const FName& InName, UTexture2D* InTexture, bool bInAlphaTexture)
+{
+	checkf(!Texture, TEXT("Trying to set resources of texture entry that is in use."));
+
+	Name = InName;
+	Texture = InTexture;
+	bAlphaTexture = bInAlphaTexture;
+
 	// Add texture to root to prevent garbage collection.
 	Texture->AddToRoot();
 
@@ -59,7 +136,7 @@ FTextureManager::FTextureEntry::FTextureEntry(const FName& InName, UTexture2D* I
 	ResourceHandle = FSlateApplication::Get().GetRenderer()->GetResourceHandle(Brush);
 }
 
-FTextureManager::FTextureEntry::~FTextureEntry()
+void FTextureManager::FTextureEntry::Reset()
 {
 	// Release brush.
 	if (Brush.HasUObject() && FSlateApplication::IsInitialized())
@@ -73,4 +150,11 @@ FTextureManager::FTextureEntry::~FTextureEntry()
 	{
 		Texture->RemoveFromRoot();
 	}
+
+	Name = NAME_None;
+	Texture = nullptr;
+	Brush = FSlateBrush{};
+	ResourceHandle = FSlateResourceHandle{};
+	bAlphaTexture = false;
+	bDistanceFieldTexture = false;
 }
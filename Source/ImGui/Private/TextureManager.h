@@ -43,12 +43,49 @@ public:
 		return TextureResources[Index].Name;
 	}
 
-	// Get the Slate Resource Handle to a texture at given index. Throws exception if index is out of range.
+	// Get the texture at given index. Released indices are mapped to the texture at index 0 (the null texture), so
+	// draw data referencing them can still be rendered. Throws exception if index is out of range.
+	// @param Index - Index of a texture
+	// @returns The texture at given index
+	FORCEINLINE UTexture2D* GetTexture(TextureIndex Index) const
+	{
+		return GetValidEntry(Index).Texture;
+	}
+
+	// Check whether texture at given index is a single-channel texture storing coverage (like alpha font atlas). Such
+	// textures cannot be drawn by Slate and need ImGui shaders. Throws exception if index is out of range.
+	// @param Index - Index of a texture
+	// @returns True, if texture at given index stores coverage in a single channel
+	FORCEINLINE bool IsAlphaTexture(TextureIndex Index) const
+	{
+		return GetValidEntry(Index).bAlphaTexture;
+	}
+
+	// Check whether alpha of texture at given index stores signed distance to glyph edges (like distance field font
+	// atlas). Such textures cannot be drawn by Slate and need ImGui shaders. Throws exception if index is out of range.
+	// @param Index - Index of a texture
+	// @returns True, if texture at given index stores distance fields
+	FORCEINLINE bool IsDistanceFieldTexture(TextureIndex Index) const
+	{
+		return GetValidEntry(Index).bDistanceFieldTexture;
+	}
+
+	// Set whether alpha of texture at given index stores signed distance to glyph edges. Throws exception if index is
+	// out of range.
+	// @param Index - Index of a texture
+	// @param bDistanceFieldTexture - Whether texture stores distance fields
+	void SetDistanceFieldTexture(TextureIndex Index, bool bDistanceFieldTexture)
+	{
+		TextureResources[Index].bDistanceFieldTexture = bDistanceFieldTexture;
+	}
+
+	// Get the Slate Resource Handle to a texture at given index. Like in GetTexture, released indices are mapped to
+	// the null texture. Throws exception if index is out of range.
 	// @param Index - Index of a texture
 	// @returns The Slate Resource Handle for a texture at given index
 	FORCEINLINE const FSlateResourceHandle& GetTextureHandle(TextureIndex Index) const
 	{
-		return TextureResources[Index].ResourceHandle;
+		return GetValidEntry(Index).ResourceHandle;
 	}
 
 	// Create a texture from raw data. Throws exception if there is already a texture with that name.
@@ -61,6 +98,31 @@ public:
 	// @returns The index of a texture that was created
 	TextureIndex CreateTexture(const FName& Name, int32 Width, int32 Height, uint32 SrcBpp, uint8* SrcData, bool bDeleteSrc = false);
 
+	// Create a texture with given pixel format from raw data. Throws exception if there is already a texture with that
+	// name.
+	// @param Name - The texture name
+	// @param Width - The texture width
+	// @param Height - The texture height
+	// @param Format - The texture pixel format (PF_G8 textures are treated as alpha textures)
+	// @param SrcBpp - The size in bytes of one pixel
+	// @param SrcData - The source data
+	// @param SrcDataCleanup - Function called on the render thread with source data, after they are uploaded
+	// @returns The index of a texture that was created
+	TextureIndex CreateTexture(const FName& Name, int32 Width, int32 Height, EPixelFormat Format, uint32 SrcBpp,
+		uint8* SrcData, TFunction<void(uint8*)> SrcDataCleanup);
+
+	// Update a region of a texture created from raw data. Throws exception if index is out of range.
+	// @param Index - Index of a texture
+	// @param X - Left edge of the region
+	// @param Y - Top edge of the region
+	// @param Width - The region width
+	// @param Height - The region height
+	// @param SrcBpp - The size in bytes of one pixel (needs to match the texture pixel format)
+	// @param SrcData - The source data with rows as wide as the region
+	// @param SrcDataCleanup - Function called on the render thread with source data, after they are uploaded
+	void UpdateTextureRegion(TextureIndex Index, int32 X, int32 Y, int32 Width, int32 Height, uint32 SrcBpp,
+		uint8* SrcData, TFunction<void(uint8*)> SrcDataCleanup);
+
 	// Create a plain texture. Throws exception if there is already a texture with that name.
 	// @param Name - The texture name
 	// @param Width - The texture width
@@ -69,16 +131,25 @@ public:
 	// @returns The index of a texture that was created
 	TextureIndex CreatePlainTexture(const FName& Name, int32 Width, int32 Height, FColor Color);
 
-	IMGUI_API TextureIndex AddTexture(const FName& Name, UTexture2D* Texture) { return TextureResources.Emplace(Name, Texture); }
+	IMGUI_API TextureIndex AddTexture(const FName& Name, UTexture2D* Texture);
+
+	// Release resources of a texture at given index. Indices of other textures don't change and this index is reused
+	// by the next created texture. Until then, it is mapped to the null texture. Throws exception if index is out of
+	// range.
+	// @param Index - Index of a texture
+	void ReleaseTexture(TextureIndex Index);
 
 private:
 
 	// Entry for texture resources. Only supports explicit construction.
 	struct FTextureEntry
 	{
-		FTextureEntry(const FName& InName, UTexture2D* InTexture);
+		FTextureEntry(const FName& InName, UTexture2D* InTexture, bool bInAlphaTexture);
 		~FTextureEntry();
 
+		// Set resources of an empty entry.
+		void Set(const FName& InName, UTexture2D* InTexture, bool bInAlphaTexture);
+
 		// Copying is not supported.
 		FTextureEntry(const FTextureEntry&) = delete;
 		FTextureEntry& operator=(const FTextureEntry&) = delete;
@@ -87,11 +158,29 @@ private:
 		FTextureEntry(FTextureEntry&&) = delete;
 		FTextureEntry& operator=(FTextureEntry&&) = delete;
 
+		// Release resources and clear this entry.
+		void Reset();
+
 		FName Name = NAME_None;
 		UTexture2D* Texture = nullptr;
 		FSlateBrush Brush;
 		FSlateResourceHandle ResourceHandle;
+		bool bAlphaTexture = false;
+		bool bDistanceFieldTexture = false;
 	};
 
+	// Get entry at given index or entry of the null texture, if that index was released.
+	FORCEINLINE const FTextureEntry& GetValidEntry(TextureIndex Index) const
+	{
+		const FTextureEntry& Entry = TextureResources[Index];
+		return Entry.Texture ? Entry : TextureResources[0];
+	}
+
+	// Add an entry, reusing a released index if there is one.
+	TextureIndex AddEntry(const FName& Name, UTexture2D* Texture, bool bAlphaTexture);
+
 	TArray<FTextureEntry> TextureResources;
+
+	// Released indices that can be reused by new textures.
+	TArray<TextureIndex> ReleasedIndices;
 };
@@ -0,0 +1,98 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#pragma once
+
+#include <HAL/PlatformAtomics.h>
+
+#include <utility>
+
+
+namespace Utilities
+{
+	//====================================================================================================
+	// Triple Buffer
+	//====================================================================================================
+
+	// Lock-free triple buffer for passing snapshots between one producer and one consumer. Producer writes to its own
+	// buffer and publishes it when complete, what gives it a new buffer to write. Consumer acquires the most recently
+	// published buffer, which stays unchanged until the next acquire. Neither side ever waits for the other.
+	//
+	// Buffers are recycled, so producer gets data that were published two or more snapshots ago. This allows to reuse
+	// allocations, but producer needs to overwrite or reset the whole buffer.
+	template<typename T>
+	class TTripleBuffer
+	{
+	public:
+
+		TTripleBuffer() = default;
+
+		TTripleBuffer(const TTripleBuffer&) = delete;
+		TTripleBuffer& operator=(const TTripleBuffer&) = delete;
+
+		// Moving is not thread-safe and should be only done when buffer is not in use.
+		TTripleBuffer(TTripleBuffer&& Other)
+			: WriteIndex(Other.WriteIndex)
+			, ReadIndex(Other.ReadIndex)
+			, SharedState(Other.SharedState)
+		{
+			for (int32 Index = 0; Index < 3; Index++)
+			{
+				Buffers[Index] = MoveTemp(Other.Buffers[Index]);
+			}
+		}
+
+		TTripleBuffer& operator=(TTripleBuffer&& Other)
+		{
+			for (int32 Index = 0; Index < 3; Index++)
+			{
+				Buffers[Index] = MoveTemp(Other.Buffers[Index]);
+			}
+			WriteIndex = Other.WriteIndex;
+			ReadIndex = Other.ReadIndex;
+			SharedState = Other.SharedState;
+			return *this;
+		}
+
+		// Get buffer owned by the producer. Should be only called by the producer.
+		T& GetWriteBuffer() { return Buffers[WriteIndex]; }
+
+		// Publish the write buffer, making it available to the consumer. After this call producer gets a new buffer
+		// and should not access the published one. Should be only called by the producer.
+		void Publish()
+		{
+			const int32 PreviousState = FPlatformAtomics::InterlockedExchange(&SharedState, WriteIndex | DirtyFlag);
+			WriteIndex = PreviousState & IndexMask;
+		}
+
+		// Acquire the most recently published buffer. If nothing was published since the last call, the previously
+		// acquired buffer is returned. Should be only called by the consumer.
+		const T& Acquire()
+		{
+			if (SharedState & DirtyFlag)
+			{
+				const int32 PreviousState = FPlatformAtomics::InterlockedExchange(&SharedState, ReadIndex);
+				ReadIndex = PreviousState & IndexMask;
+			}
+			return Buffers[ReadIndex];
+		}
+
+		// Get buffer acquired by the last call to Acquire. Should be only called by the consumer.
+		const T& GetReadBuffer() const { return Buffers[ReadIndex]; }
+
+	private:
+
+		static constexpr int32 IndexMask = 0x3;
+		static constexpr int32 DirtyFlag = 0x4;
+
+		T Buffers[3];
+
+		// Index of the buffer owned by the producer.
+		int32 WriteIndex = 0;
+
+		// Index of the buffer owned by the consumer.
+		int32 ReadIndex = 1;
+
+		// Index of the shared buffer with a flag marking whether it was published since the last acquire.
+		volatile int32 SharedState = 2;
+	};
+}
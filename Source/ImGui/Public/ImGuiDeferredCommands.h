@@ -0,0 +1,53 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#pragma once
+
+#include <CoreMinimal.h>
+
+
+/**
+ * Command with ImGui calls recorded on any thread and replayed later on the game thread, with the target context set
+ * as current. Data needed by the command should be captured by value, since it runs after the recording code returns.
+ */
+typedef TFunction<void()> FImGuiDeferredCommand;
+
+/**
+ * Handle to ImGui context, which can be used to record deferred commands from any thread.
+ */
+class FImGuiContextHandle
+{
+public:
+
+	FImGuiContextHandle() = default;
+
+	bool IsValid() const
+	{
+		return Index != INDEX_NONE;
+	}
+
+	void Reset()
+	{
+		Index = INDEX_NONE;
+	}
+
+private:
+
+	explicit FImGuiContextHandle(int32 InIndex)
+		: Index(InIndex)
+	{
+	}
+
+	friend bool operator==(const FImGuiContextHandle& Lhs, const FImGuiContextHandle& Rhs)
+	{
+		return Lhs.Index == Rhs.Index;
+	}
+
+	friend bool operator!=(const FImGuiContextHandle& Lhs, const FImGuiContextHandle& Rhs)
+	{
+		return !(Lhs == Rhs);
+	}
+
+	int32 Index = INDEX_NONE;
+
+	friend class FImGuiModule;
+};
@@ -2,11 +2,16 @@
 
 #pragma once
 
+#include "ImGuiDeferredCommands.h"
 #include "ImGuiDelegates.h"
 
 #include "Modules/ModuleManager.h"
 
 class FImGuiModuleManager;
+struct ImDrawList;
+struct ImFont;
+struct ImFontAtlas;
+struct ImFontConfig;
 
 class FImGuiModule : public IModuleInterface
 {
@@ -70,6 +75,85 @@ public:
 	 */
 	virtual void RemoveImGuiDelegate(const FImGuiDelegateHandle& Handle);
 
+#if WITH_EDITOR
+	/**
+	 * Get handle to the editor ImGui context, creating that context on demand. Should be called on the game thread,
+	 * but the handle can be passed to and used in any thread.
+	 *
+	 * @returns Returns handle that can be used to record deferred commands (@see RecordImGuiCommand)
+	 */
+	virtual FImGuiContextHandle GetEditorContextHandle();
+#endif
+
+	/**
+	 * Get handle to the ImGui context of the current world, creating that context on demand. Should be called on the
+	 * game thread, but the handle can be passed to and used in any thread.
+	 * This function will throw if called outside of a world context (i.e. current world cannot be found).
+	 *
+	 * @returns Returns handle that can be used to record deferred commands (@see RecordImGuiCommand)
+	 */
+	virtual FImGuiContextHandle GetWorldContextHandle();
+
+	/**
+	 * Record a command with ImGui calls to be replayed in the given context during its next draw event. This can be
+	 * called from any thread (including worker threads that cannot call ImGui directly) and it doesn't block.
+	 * Commands are replayed on the game thread ordered by sort key and after that by the order in which they were
+	 * recorded. Commands from different threads that use the same key are ordered by the order in which those threads
+	 * recorded their first commands, so using different keys for different jobs gives fully deterministic output.
+	 *
+	 * @param Context - Handle to the target context (@see Get...ContextHandle)
+	 * @param Command - Command to replay, with all the data it needs captured by value
+	 * @param SortKey - Key defining replay order (commands with lower keys are replayed first)
+	 */
+	virtual void RecordImGuiCommand(const FImGuiContextHandle& Context, FImGuiDeferredCommand Command, int32 SortKey = 0);
+
+	/**
+	 * Get a draw list in which the calling thread can emit raw primitives (lines, rectangles, text etc.) to be rendered
+	 * in the given context. Every call returns a different list, so threads can draw in parallel without any
+	 * synchronization. Lists share the font atlas and draw list data with their context.
+	 * This can be called from any thread. List needs to be passed to EndPrimitiveDrawList in the same frame and before
+	 * the context is destroyed.
+	 *
+	 * @param Context - Handle to the target context (@see Get...ContextHandle)
+	 * @returns Returns an empty draw list or null, if handle doesn't point to an existing context
+	 */
+	virtual ImDrawList* BeginPrimitiveDrawList(const FImGuiContextHandle& Context);
+
+	/**
+	 * Publish a draw list taken from BeginPrimitiveDrawList, so it is rendered at the end of the current frame of its
+	 * context. After this call list should not be used anymore. Lists are rendered in order of their layer keys: those
+	 * with negative keys below ImGui windows and the rest above them.
+	 * This can be called from any thread.
+	 *
+	 * @param DrawList - Draw list taken from BeginPrimitiveDrawList
+	 * @param LayerKey - Key defining rendering order (lists with lower keys are rendered first)
+	 */
+	virtual void EndPrimitiveDrawList(ImDrawList* DrawList, int32 LayerKey = 0);
+
+	/**
+	 * Get font atlas shared by all ImGui contexts. Fonts can be added to the atlas until it is built, what happens when
+	 * the first context is created (@see AddFont to add fonts after that). Font configs with large glyph ranges (like CJK) are not rasterized when the atlas
+	 * is built, but only when their glyphs are used (@see ImGui.DynamicGlyphs.MinGlyphs). Font data and glyph ranges
+	 * need to stay valid as long as the module is loaded.
+	 * Should be called on the game thread.
+	 *
+	 * @returns Returns the shared font atlas
+	 */
+	virtual ImFontAtlas& GetFontAtlas();
+
+	/**
+	 * Add a font to the font atlas shared by all ImGui contexts. Before the atlas is built, this is the same as adding
+	 * font directly to the atlas. After that, glyphs are rasterized into free space in the atlas and only the changed
+	 * part of the atlas texture is updated. Fonts merged into existing ones and fonts that don't fit into free space
+	 * are added before ImGui contexts advance to the next frame (the atlas is rebuilt only if there is not enough free
+	 * space), so until then their glyphs are missing.
+	 * Should be called on the game thread, outside of ImGui draw events.
+	 *
+	 * @param FontConfig - Config of a font to add (@see ImFontAtlas::AddFont)
+	 * @returns Returns the added font (or the font to which config is merged), which can be used immediately
+	 */
+	virtual ImFont* AddFont(const ImFontConfig& FontConfig);
+
 	/**
 	 * Check whether Input Mode is enabled (tests ImGui.InputEnabled console variable).
 	 *
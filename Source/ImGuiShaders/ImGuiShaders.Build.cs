@@ -0,0 +1,41 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+using System.IO;
+using UnrealBuildTool;
+
+// Global shaders used to render ImGui output. They are kept in a separate module, because shader types need to be
+// registered in the PostConfigInit loading phase, which is too early for the main ImGui module.
+public class ImGuiShaders : ModuleRules
+{
+#if WITH_FORWARDED_MODULE_RULES_CTOR
+	public ImGuiShaders(ReadOnlyTargetRules Target) : base(Target)
+#else
+	public ImGuiShaders(TargetInfo Target)
+#endif
+	{
+
+		PublicIncludePaths.AddRange(
+			new string[] {
+				Path.Combine(ModuleDirectory, "Public")
+			}
+			);
+
+
+		PrivateIncludePaths.AddRange(
+			new string[] {
+				Path.Combine(ModuleDirectory, "Private")
+			}
+			);
+
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"RenderCore",
+				"RHI",
+				"ShaderCore"
+			}
+			);
+	}
+}
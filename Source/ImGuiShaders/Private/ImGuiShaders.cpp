@@ -0,0 +1,64 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#include "ImGuiShaders.h"
+
+#include <Modules/ModuleManager.h>
+
+
+// Shaders are in a separate module, so they can be registered before shader initialization (PostConfigInit loading
+// phase), without loading the rest of the plugin that early.
+IMPLEMENT_MODULE(FDefaultModuleImpl, ImGuiShaders)
+
+#if WITH_IMGUI_SHADERS
+
+#include <RHIStaticStates.h>
+#include <ShaderParameterUtils.h>
+
+
+IMPLEMENT_SHADER_TYPE(, FImGuiVS, TEXT("/Plugin/ImGui/Private/ImGui.usf"), TEXT("MainVS"), SF_Vertex);
+IMPLEMENT_SHADER_TYPE(, FImGuiPS, TEXT("/Plugin/ImGui/Private/ImGui.usf"), TEXT("MainPS"), SF_Pixel);
+
+
+FImGuiVS::FImGuiVS(const ShaderMetaType::CompiledShaderInitializerType& Initializer)
+	: FGlobalShader(Initializer)
+{
+	Transform.Bind(Initializer.ParameterMap, TEXT("Transform"));
+}
+
+void FImGuiVS::SetParameters(FRHICommandList& RHICmdList, const FVector2D& Scale, const FVector2D& Bias)
+{
+	SetShaderValue(RHICmdList, GetVertexShader(), Transform, FVector4{ Scale.X, Scale.Y, Bias.X, Bias.Y });
+}
+
+bool FImGuiVS::Serialize(FArchive& Ar)
+{
+	const bool bShaderHasOutdatedParameters = FGlobalShader::Serialize(Ar);
+	Ar << Transform;
+	return bShaderHasOutdatedParameters;
+}
+
+FImGuiPS::FImGuiPS(const ShaderMetaType::CompiledShaderInitializerType& Initializer)
+	: FGlobalShader(Initializer)
+{
+	Texture.Bind(Initializer.ParameterMap, TEXT("Texture"));
+	Sampler.Bind(Initializer.ParameterMap, TEXT("Sampler"));
+	AlphaTexture.Bind(Initializer.ParameterMap, TEXT("AlphaTexture"));
+	DistanceFieldTexture.Bind(Initializer.ParameterMap, TEXT("DistanceFieldTexture"));
+}
+
+void FImGuiPS::SetTexture(FRHICommandList& RHICmdList, FTextureRHIParamRef TextureRHI, bool bAlphaTexture,
+	bool bDistanceFieldTexture)
+{
+	SetTextureParameter(RHICmdList, GetPixelShader(), Texture, Sampler, TStaticSamplerState<SF_Bilinear>::GetRHI(), TextureRHI);
+	SetShaderValue(RHICmdList, GetPixelShader(), AlphaTexture, bAlphaTexture ? 1.f : 0.f);
+	SetShaderValue(RHICmdList, GetPixelShader(), DistanceFieldTexture, bDistanceFieldTexture ? 1.f : 0.f);
+}
+
+bool FImGuiPS::Serialize(FArchive& Ar)
+{
+	const bool bShaderHasOutdatedParameters = FGlobalShader::Serialize(Ar);
+	Ar << Texture << Sampler << AlphaTexture << DistanceFieldTexture;
+	return bShaderHasOutdatedParameters;
+}
+
+#endif // WITH_IMGUI_SHADERS
@@ -0,0 +1,75 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Runtime/Launch/Resources/Version.h>
+
+// Global shaders in plugin directories are supported from engine version 4.17.
+#define WITH_IMGUI_SHADERS		(ENGINE_MAJOR_VERSION > 4 || (ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 17))
+
+#if WITH_IMGUI_SHADERS
+
+#include <GlobalShader.h>
+#include <ShaderParameters.h>
+
+
+// Vertex shader transforming ImGui vertices from render target pixels to clip space.
+class IMGUISHADERS_API FImGuiVS : public FGlobalShader
+{
+	DECLARE_SHADER_TYPE(FImGuiVS, Global);
+
+public:
+
+	static bool ShouldCache(EShaderPlatform Platform) { return true; }
+
+	FImGuiVS() = default;
+
+	FImGuiVS(const ShaderMetaType::CompiledShaderInitializerType& Initializer);
+
+	// Set transform from render target pixels to clip space.
+	// @param RHICmdList - Command list
+	// @param Scale - Scale applied to vertex positions
+	// @param Bias - Bias added to scaled vertex positions
+	void SetParameters(FRHICommandList& RHICmdList, const FVector2D& Scale, const FVector2D& Bias);
+
+	virtual bool Serialize(FArchive& Ar) override;
+
+private:
+
+	FShaderParameter Transform;
+};
+
+// Pixel shader modulating texture with vertex color.
+class IMGUISHADERS_API FImGuiPS : public FGlobalShader
+{
+	DECLARE_SHADER_TYPE(FImGuiPS, Global);
+
+public:
+
+	static bool ShouldCache(EShaderPlatform Platform) { return true; }
+
+	FImGuiPS() = default;
+
+	FImGuiPS(const ShaderMetaType::CompiledShaderInitializerType& Initializer);
+
+	// Set texture sampled by this shader.
+	// @param RHICmdList - Command list
+	// @param TextureRHI - Texture to bind
+	// @param bAlphaTexture - Whether texture is single-channel, with coverage in the red channel (sampled as white
+	//     colour with that alpha)
+	// @param bDistanceFieldTexture - Whether texture alpha stores signed distance to glyph edges, rather than coverage
+	void SetTexture(FRHICommandList& RHICmdList, FTextureRHIParamRef TextureRHI, bool bAlphaTexture = false,
+		bool bDistanceFieldTexture = false);
+
+	virtual bool Serialize(FArchive& Ar) override;
+
+private:
+
+	FShaderResourceParameter Texture;
+	FShaderResourceParameter Sampler;
+	FShaderParameter AlphaTexture;
+	FShaderParameter DistanceFieldTexture;
+};
+
+#endif // WITH_IMGUI_SHADERS
@@ -50,6 +50,98 @@
 //---- Use 32-bit vertex indices (instead of default: 16-bit) to allow meshes with more than 64K vertices
 //#define ImDrawIdx unsigned int
 
+//---- Unreal ImGui: Use 32-bit vertex indices to lift the limit of 64K vertices per window. Slate uses 32-bit indices on
+//---- most platforms, so index data can be passed to Slate by a block copy. Define as 0 to use 16-bit indices.
+#ifndef IMGUI_USE_32BIT_INDICES
+#define IMGUI_USE_32BIT_INDICES         1
+#endif
+
+#if IMGUI_USE_32BIT_INDICES
+#define ImDrawIdx unsigned int
+#endif // IMGUI_USE_32BIT_INDICES
+
+//---- Unreal ImGui: Use vertex layout and color packing compatible with Slate vertices (FSlateVertex), so ImGui output
+//---- can be passed to Slate by a block copy. Layout compatibility is verified at compile time in ImGuiDrawData.cpp.
+//---- Supported from engine version 4.17 (older versions have per-vertex clipping rectangles). Define as 0 to use the
+//---- standard ImGui layout.
+#ifndef IMGUI_USE_SLATE_VERTEX_LAYOUT
+#include "Runtime/Launch/Resources/Version.h"
+#define IMGUI_USE_SLATE_VERTEX_LAYOUT   (ENGINE_MAJOR_VERSION > 4 || (ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION >= 17))
+#endif
+
+#if IMGUI_USE_SLATE_VERTEX_LAYOUT
+// FColor packs channels as ARGB, what matches the BGRA packing in ImGui.
+#define IMGUI_USE_BGRA_PACKED_COLOR
+// Mirrors FSlateVertex: uv and uv_scale map to TexCoords (final UV is calculated in shader as XY * ZW), followed by
+// MaterialTexCoords, Position, Color and PixelSize. ImGui only writes pos, uv and col.
+#define IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT                               \
+        struct ImDrawVert                                                   \
+        {                                                                   \
+            ImVec2  uv;                                                     \
+            ImVec2  uv_scale;                                               \
+            ImVec2  material_uv;                                            \
+            ImVec2  pos;                                                    \
+            ImU32   col;                                                    \
+            unsigned short pixel_size[2];                                   \
+        }
+#endif // IMGUI_USE_SLATE_VERTEX_LAYOUT
+
+//---- Unreal ImGui: Make the current context pointer thread-local, so different contexts can be updated on different
+//---- threads at the same time. Each thread starts with the default context. Parallel context ticking and any-thread
+//---- draw lists depend on it, so this is not optional. Thread-local data cannot be exported, so the pointer is accessed
+//---- through an exported function defined in ImGuiImplementation.cpp.
+struct ImGuiContext;
+IMGUI_API ImGuiContext*& ImGuiGetThreadContextRef();
+#define GImGui (ImGuiGetThreadContextRef())
+
+//---- Unreal ImGui: Call a hook when ImFont::FindGlyph, CalcTextSizeA or CalcWordWrapPositionA don't find a glyph, so
+//---- missing glyphs can be rasterized on demand.
+//---- Hook can be called from any thread and is defined in ImGuiDynamicGlyphs.cpp. Define as 0 to disable.
+#ifndef IMGUI_USE_GLYPH_MISS_HOOK
+#define IMGUI_USE_GLYPH_MISS_HOOK       1
+#endif
+
+#if IMGUI_USE_GLYPH_MISS_HOOK
+struct ImFont;
+void ImGuiOnGlyphMiss(const ImFont* font, unsigned short c);
+#define IMGUI_ON_GLYPH_MISS(font, c)    ImGuiOnGlyphMiss(font, c)
+#endif // IMGUI_USE_GLYPH_MISS_HOOK
+
+//---- Unreal ImGui: Call hooks around ImFont functions that measure and render text (CalcTextSizeA, RenderText, etc.),
+//---- so fonts can be locked against them while they are modified and other threads (like those with primitive draw
+//---- lists) can still use them. Hooks can be called from any thread and can be nested. They are defined in
+//---- ImGuiSharedFontAtlas.cpp. Define as 0 to disable.
+#ifndef IMGUI_USE_FONT_ACCESS_HOOKS
+#define IMGUI_USE_FONT_ACCESS_HOOKS     1
+#endif
+
+#if IMGUI_USE_FONT_ACCESS_HOOKS
+void ImGuiBeginFontAccess();
+void ImGuiEndFontAccess();
+#define IMGUI_BEGIN_FONT_ACCESS()       ImGuiBeginFontAccess()
+#define IMGUI_END_FONT_ACCESS()         ImGuiEndFontAccess()
+#endif // IMGUI_USE_FONT_ACCESS_HOOKS
+
+//---- Unreal ImGui: Render glyphs in parallel when building font atlas. Rectangles are still packed on the calling thread,
+//---- so the result is the same as in a serial build. Parallel-for is defined in ImGuiSharedFontAtlas.cpp and it calls
+//---- func(user_data, index) for each index in [0, count). Define as 0 to build atlas on the calling thread.
+#ifndef IMGUI_USE_PARALLEL_FONT_BUILD
+#define IMGUI_USE_PARALLEL_FONT_BUILD   1
+#endif
+
+#if IMGUI_USE_PARALLEL_FONT_BUILD
+void ImGuiFontBuildParallelFor(int count, void (*func)(void* user_data, int index), void* user_data);
+#define IMGUI_FONT_BUILD_PARALLEL_FOR(count, func, user_data)   ImGuiFontBuildParallelFor(count, func, user_data)
+#endif // IMGUI_USE_PARALLEL_FONT_BUILD
+
+//---- Unreal ImGui: Font config flag (ImFontConfig::RasterizerFlags) to render glyphs as signed distance fields rather
+//---- than coverage, so one glyph set can be drawn at any scale. Distance is stored in alpha, with 0.5 at glyph edges,
+//---- and covers IMGUI_SDF_FONT_SPREAD pixels on both sides of them. Such glyphs need a matching shader (see ImGui.usf).
+#define ImFontRasterizerFlags_SDF       (1u << 31)
+#ifndef IMGUI_SDF_FONT_SPREAD
+#define IMGUI_SDF_FONT_SPREAD           4
+#endif
+
 //---- Tip: You can add extra functions within the ImGui:: namespace, here or in your own headers files.
 //---- e.g. create variants of the ImGui::Value() helper for your low-level math types, or your own widgets/helpers.
 /*
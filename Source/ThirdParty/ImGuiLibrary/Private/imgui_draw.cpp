@@ -93,8 +93,14 @@ namespace IMGUI_STB_NAMESPACE
 #endif
 #include "stb_rect_pack.h"
 
+#ifdef IMGUI_FONT_BUILD_PARALLEL_FOR
+// Glyphs can be rasterized on worker threads, which share the context, so allocations bypass its (non-atomic) metrics.
+#define STBTT_malloc(x,u)  ((void)(u), GImGui->IO.MemAllocFn(x))
+#define STBTT_free(x,u)    ((void)(u), GImGui->IO.MemFreeFn(x))
+#else
 #define STBTT_malloc(x,u)  ((void)(u), ImGui::MemAlloc(x))
 #define STBTT_free(x,u)    ((void)(u), ImGui::MemFree(x))
+#endif
 #define STBTT_assert(x)    IM_ASSERT(x)
 #ifndef IMGUI_DISABLE_STB_TRUETYPE_IMPLEMENTATION
 #define STBTT_STATIC
@@ -1627,6 +1633,124 @@ void    ImFontAtlasBuildMultiplyRectAlpha8(const unsigned char table[256], unsig
             data[i] = table[data[i]];
 }
 
+// Extend packing rectangles of glyphs rendered as signed distance fields, so they have room for the distance on all sides.
+static void ImFontAtlasBuildExtendRectsSDF(stbrp_rect* rects, int rects_count)
+{
+    for (int i = 0; i < rects_count; i++)
+    {
+        rects[i].w += 2 * IMGUI_SDF_FONT_SPREAD;
+        rects[i].h += 2 * IMGUI_SDF_FONT_SPREAD;
+    }
+}
+
+// Convert rendered glyph coverage to signed distance fields, in place. Glyphs are rendered in the top-left corner of
+// rectangles extended with ImFontAtlasBuildExtendRectsSDF, so they are moved to the middle, and packed characters are
+// updated to cover the whole rectangles. Edge pixels take the sub-pixel distance from their coverage and the rest take
+// the distance to the nearest pixel on the other side of the edge.
+static void ImFontAtlasBuildConvertToSDF(unsigned char* pixels, int stride, stbtt_pack_range* ranges, int ranges_count, stbrp_rect* rects)
+{
+    const int spread = IMGUI_SDF_FONT_SPREAD;
+    const int search = spread + 1;
+    int k = 0;
+    for (int i = 0; i < ranges_count; i++)
+    {
+        const stbtt_pack_range& range = ranges[i];
+        for (int j = 0; j < range.num_chars; j++, k++)
+        {
+            const stbrp_rect& r = rects[k];
+            if (!r.was_packed)
+                continue;
+
+            const int w = r.w, h = r.h;
+            unsigned char* coverage = (unsigned char*)STBTT_malloc(w * h, NULL);
+            memset(coverage, 0, w * h);
+            for (int y = 0; y < h - 2 * spread; y++)
+                memcpy(coverage + (y + spread) * w + spread, pixels + (r.y + y) * stride + r.x, w - 2 * spread);
+
+            for (int y = 0; y < h; y++)
+            {
+                for (int x = 0; x < w; x++)
+                {
+                    const unsigned char c = coverage[y * w + x];
+                    const bool inside = c >= 128;
+                    float distance;
+                    if (c > 0 && c < 255)
+                    {
+                        distance = c / 255.0f - 0.5f;
+                    }
+                    else
+                    {
+                        int best_sq = search * search;
+                        for (int dy = -search; dy <= search; dy++)
+                            for (int dx = -search; dx <= search; dx++)
+                            {
+                                const int qx = x + dx, qy = y + dy;
+                                const bool q_inside = qx >= 0 && qy >= 0 && qx < w && qy < h && coverage[qy * w + qx] >= 128;
+                                if (q_inside != inside && dx * dx + dy * dy < best_sq)
+                                    best_sq = dx * dx + dy * dy;
+                            }
+                        distance = sqrtf((float)best_sq) - 0.5f;
+                        if (!inside)
+                            distance = -distance;
+                    }
+                    const float value = ImClamp(0.5f + 0.5f * distance / spread, 0.0f, 1.0f);
+                    pixels[(r.y + y) * stride + r.x + x] = (unsigned char)(value * 255.0f + 0.5f);
+                }
+            }
+            STBTT_free(coverage, NULL);
+
+            // Rectangle now starts spread pixels before the glyph.
+            stbtt_packedchar& pc = range.chardata_for_range[j];
+            pc.xoff -= (float)spread / range.h_oversample;
+            pc.xoff2 -= (float)spread / range.h_oversample;
+            pc.yoff -= (float)spread / range.v_oversample;
+            pc.yoff2 -= (float)spread / range.v_oversample;
+        }
+    }
+}
+
+#ifdef IMGUI_FONT_BUILD_PARALLEL_FOR
+// Rendering task covering a part of one glyph range. Rectangles are packed before rendering, so tasks write to disjoint
+// parts of the texture and the output doesn't depend on the order in which they are executed.
+struct ImFontBuildRenderTask
+{
+    const ImFontConfig*     Cfg;
+    const stbtt_fontinfo*   FontInfo;
+    stbtt_pack_range        Range;
+    stbrp_rect*             Rects;
+};
+
+struct ImFontBuildRenderData
+{
+    const stbtt_pack_context*       Spc;
+    ImVector<ImFontBuildRenderTask> Tasks;
+};
+
+static void ImFontAtlasBuildRenderTask(void* user_data, int task_i)
+{
+    const ImFontBuildRenderData& data = *(const ImFontBuildRenderData*)user_data;
+    const ImFontBuildRenderTask& task = data.Tasks[task_i];
+
+    // Context copy, because rendering temporarily changes oversampling stored in it.
+    stbtt_pack_context spc = *data.Spc;
+    stbtt_pack_range range = task.Range;
+    stbtt_PackSetOversampling(&spc, task.Cfg->OversampleH, task.Cfg->OversampleV);
+    stbtt_PackFontRangesRenderIntoRects(&spc, task.FontInfo, &range, 1, task.Rects);
+    if (task.Cfg->RasterizerFlags & ImFontRasterizerFlags_SDF)
+    {
+        ImFontAtlasBuildConvertToSDF(spc.pixels, spc.stride_in_bytes, &range, 1, task.Rects);
+    }
+    else if (task.Cfg->RasterizerMultiply != 1.0f)
+    {
+        unsigned char multiply_table[256];
+        ImFontAtlasBuildMultiplyCalcLookupTable(multiply_table, task.Cfg->RasterizerMultiply);
+        for (const stbrp_rect* r = task.Rects; r != task.Rects + range.num_chars; r++)
+            if (r->was_packed)
+                ImFontAtlasBuildMultiplyRectAlpha8(multiply_table, spc.pixels, r->x, r->y, r->w, r->h, spc.stride_in_bytes);
+    }
+}
+#endif
+
 bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
 {
     IM_ASSERT(atlas->ConfigData.Size > 0);
@@ -1730,6 +1854,8 @@ bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
         stbtt_PackSetOversampling(&spc, cfg.OversampleH, cfg.OversampleV);
         int n = stbtt_PackFontRangesGatherRects(&spc, &tmp.FontInfo, tmp.Ranges, tmp.RangesCount, tmp.Rects);
         IM_ASSERT(n == font_glyphs_count);
+        if (cfg.RasterizerFlags & ImFontRasterizerFlags_SDF)
+            ImFontAtlasBuildExtendRectsSDF(tmp.Rects, n);
         stbrp_pack_rects((stbrp_context*)spc.pack_info, tmp.Rects, n);
 
         // Extend texture height
@@ -1749,13 +1875,47 @@ bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
     spc.height = atlas->TexHeight;
 
     // Second pass: render font characters
+#ifdef IMGUI_FONT_BUILD_PARALLEL_FOR
+    // Split ranges into tasks with a limited number of glyphs, so large ranges are also rendered in parallel.
+    const int glyphs_per_task = 256;
+    ImFontBuildRenderData render_data;
+    render_data.Spc = &spc;
+    for (int input_i = 0; input_i < atlas->ConfigData.Size; input_i++)
+    {
+        ImFontTempBuildData& tmp = tmp_array[input_i];
+        stbrp_rect* rects = tmp.Rects;
+        for (int i = 0; i < tmp.RangesCount; i++)
+        {
+            const stbtt_pack_range& range = tmp.Ranges[i];
+            for (int char_idx = 0; char_idx < range.num_chars; char_idx += glyphs_per_task)
+            {
+                ImFontBuildRenderTask task;
+                task.Cfg = &atlas->ConfigData[input_i];
+                task.FontInfo = &tmp.FontInfo;
+                task.Range = range;
+                task.Range.first_unicode_codepoint_in_range = range.first_unicode_codepoint_in_range + char_idx;
+                task.Range.num_chars = ImMin(glyphs_per_task, range.num_chars - char_idx);
+                task.Range.chardata_for_range = range.chardata_for_range + char_idx;
+                task.Rects = rects + char_idx;
+                render_data.Tasks.push_back(task);
+            }
+            rects += range.num_chars;
+        }
+        tmp.Rects = NULL;
+    }
+    IMGUI_FONT_BUILD_PARALLEL_FOR(render_data.Tasks.Size, &ImFontAtlasBuildRenderTask, &render_data);
+#else
     for (int input_i = 0; input_i < atlas->ConfigData.Size; input_i++)
     {
         ImFontConfig& cfg = atlas->ConfigData[input_i];
         ImFontTempBuildData& tmp = tmp_array[input_i];
         stbtt_PackSetOversampling(&spc, cfg.OversampleH, cfg.OversampleV);
         stbtt_PackFontRangesRenderIntoRects(&spc, &tmp.FontInfo, tmp.Ranges, tmp.RangesCount, tmp.Rects);
-        if (cfg.RasterizerMultiply != 1.0f)
+        if (cfg.RasterizerFlags & ImFontRasterizerFlags_SDF)
+        {
+            ImFontAtlasBuildConvertToSDF(spc.pixels, spc.stride_in_bytes, tmp.Ranges, tmp.RangesCount, tmp.Rects);
+        }
+        else if (cfg.RasterizerMultiply != 1.0f)
         {
             unsigned char multiply_table[256];
             ImFontAtlasBuildMultiplyCalcLookupTable(multiply_table, cfg.RasterizerMultiply);
@@ -1765,6 +1925,7 @@ bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
         }
         tmp.Rects = NULL;
     }
+#endif
 
     // End packing
     stbtt_PackEnd(&spc);
@@ -2223,6 +2384,18 @@ void ImFont::AddRemapChar(ImWchar dst, ImWchar src, bool overwrite_dst)
     IndexAdvanceX[dst] = (src < index_size) ? IndexAdvanceX.Data[src] : 1.0f;
 }
 
+//---- Unreal ImGui: Scope in which font is used by text functions (see IMGUI_BEGIN_FONT_ACCESS in imconfig.h).
+#ifdef IMGUI_BEGIN_FONT_ACCESS
+struct ImFontAccessScope
+{
+    ImFontAccessScope()     { IMGUI_BEGIN_FONT_ACCESS(); }
+    ~ImFontAccessScope()    { IMGUI_END_FONT_ACCESS(); }
+};
+#define IM_FONT_ACCESS_SCOPE()  ImFontAccessScope font_access_scope
+#else
+#define IM_FONT_ACCESS_SCOPE()
+#endif
+
 const ImFontGlyph* ImFont::FindGlyph(ImWchar c) const
 {
     if (c < IndexLookup.Size)
@@ -2231,11 +2404,15 @@ const ImFontGlyph* ImFont::FindGlyph(ImWchar c) const
         if (i != (unsigned short)-1)
             return &Glyphs.Data[i];
     }
+#ifdef IMGUI_ON_GLYPH_MISS
+    IMGUI_ON_GLYPH_MISS(this, c);
+#endif
     return FallbackGlyph;
 }
 
 const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const char* text_end, float wrap_width) const
 {
+    IM_FONT_ACCESS_SCOPE();
     // Simple word-wrapping for English, not full-featured. Please submit failing cases!
     // FIXME: Much possible improvements (don't cut things like "word !", "word!!!" but cut within "word,,,,", more sensible support for punctuations, support for Unicode punctuations, etc.)
 
@@ -2289,6 +2466,11 @@ const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const c
         }
 
         const float char_width = ((int)c < IndexAdvanceX.Size ? IndexAdvanceX[(int)c] : FallbackAdvanceX);
+#ifdef IMGUI_ON_GLYPH_MISS
+        //---- Unreal ImGui: Text can be measured without looking up glyphs, so report misses here as well.
+        if (c < 0x10000 && ((int)c >= IndexLookup.Size || IndexLookup[(int)c] == (unsigned short)-1))
+            IMGUI_ON_GLYPH_MISS(this, (unsigned short)c);
+#endif
         if (ImCharIsSpace(c))
         {
             if (inside_word)
@@ -2335,6 +2517,7 @@ const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const c
 
 ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, const char* text_begin, const char* text_end, const char** remaining) const
 {
+    IM_FONT_ACCESS_SCOPE();
     if (!text_end)
         text_end = text_begin + strlen(text_begin); // FIXME-OPT: Need to avoid this.
 
@@ -2406,6 +2589,11 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
         }
 
         const float char_width = ((int)c < IndexAdvanceX.Size ? IndexAdvanceX[(int)c] : FallbackAdvanceX) * scale;
+#ifdef IMGUI_ON_GLYPH_MISS
+        //---- Unreal ImGui: Text can be measured without looking up glyphs, so report misses here as well.
+        if (c < 0x10000 && ((int)c >= IndexLookup.Size || IndexLookup[(int)c] == (unsigned short)-1))
+            IMGUI_ON_GLYPH_MISS(this, (unsigned short)c);
+#endif
         if (line_width + char_width >= max_width)
         {
             s = prev_s;
@@ -2429,6 +2617,7 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
 
 void ImFont::RenderChar(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col, unsigned short c) const
 {
+    IM_FONT_ACCESS_SCOPE();
     if (c == ' ' || c == '\t' || c == '\n' || c == '\r') // Match behavior of RenderText(), those 4 codepoints are hard-coded.
         return;
     if (const ImFontGlyph* glyph = FindGlyph(c))
@@ -2443,6 +2632,7 @@ void ImFont::RenderChar(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
 
 void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col, const ImVec4& clip_rect, const char* text_begin, const char* text_end, float wrap_width, bool cpu_fine_clip) const
 {
+    IM_FONT_ACCESS_SCOPE();
     if (!text_end)
         text_end = text_begin + strlen(text_begin); // ImGui functions generally already provides a valid text_end, so this is merely to handle direct calls.
 